@@ -28,6 +28,7 @@ public class Context : ModuleRules
 				"CommonUI",
 				"Core",
 				"CoreUObject",
+				"DeveloperSettings",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
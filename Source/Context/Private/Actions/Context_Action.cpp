@@ -13,11 +13,21 @@ AActor* UContext_Action::GetInstigator() {
 
 AHUD* UContext_Action::GetLocalPlayerHUD() const {
 	const APlayerController* PC = UGameplayStatics::GetPlayerController(GetWorld(), 0);
-	return PC->GetHUD();
+	return PC ? PC->GetHUD() : nullptr;
 }
 
 APlayerController* UContext_Action::GetLocalPlayerControllerForAction() const {
-	return GEngine->GetFirstLocalPlayerController(GetWorld());
+	const UWorld* World = GetWorld();
+	return World ? GEngine->GetFirstLocalPlayerController(World) : nullptr;
+}
+
+AHUD* UContext_Action::GetLocalPlayerHUDForContext(const FContext_ActionExecutionContext& ExecutionContext) {
+	const APlayerController* PC = UGameplayStatics::GetPlayerController(ExecutionContext.World, 0);
+	return PC ? PC->GetHUD() : nullptr;
+}
+
+APlayerController* UContext_Action::GetLocalPlayerControllerForContext(const FContext_ActionExecutionContext& ExecutionContext) {
+	return ExecutionContext.World ? GEngine->GetFirstLocalPlayerController(ExecutionContext.World) : nullptr;
 }
 
 UWorld* UContext_Action::GetWorld() const {
@@ -40,6 +50,24 @@ UWorld* UContext_Action::GetWorld() const {
 void UContext_Action::CommitPayload(const UContext_ActionPayloadBase* Payload) {
 }
 
+bool UContext_Action::IsPayloadValid(const UContext_ActionPayloadBase* Payload) const {
+	// is no payload is set, we expect a nullptr
+	if (!IsValid(PayloadClass)) {
+		return Payload == nullptr;
+	}
+
+	// if our payload is different than the desired payload, fail
+	if (!IsValid(Payload) || Payload->GetClass() != PayloadClass) {
+		UE_LOG(LogContextSystem, Error, TEXT("Incorrect payload type passed to %s. Expected %s but got %s"),
+			*GetName(),
+			*PayloadClass->GetName(),
+			IsValid(Payload) ? *Payload->GetClass()->GetName() : TEXT("null"))
+		return false;
+	}
+	
+	return true;
+}
+
 #if WITH_EDITOR
 EDataValidationResult UContext_Action::IsDataValid(FDataValidationContext& Context) const {
 	const EDataValidationResult BaseResult = UObject::IsDataValid(Context);
@@ -3,16 +3,169 @@
 
 #include "Actions/Context_ActionEntry.h"
 
+#include "Context_Stats.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Interface/Context_PayloadFunctionTable.h"
+#include "Internationalization/TextInspector.h"
+#include "UObject/ObjectSaveContext.h"
+#include "Actions/Context_Action.h"
+#include "Actions/Context_ActionSubsystem.h"
 #include "Validation/Context_ActionValidation.h"
 
+UClass* UContext_ActionEntry::LoadActionClass() const {
+	if (UClass* ActionClass = Action.Get()) {
+		return ActionClass;
+	}
+
+	if (Action.IsNull()) {
+		return nullptr;
+	}
+	
+	UE_LOG(LogContextSubsystem, Verbose, TEXT("Action %ls of entry %ls was not streamed in before use, loading it now"),
+		*Action.ToString(),
+		*GetName());
+	return Action.LoadSynchronous();
+}
+
+FSoftObjectPath UContext_ActionEntry::GetActionPayloadClassPath() const {
+	// The action is the source of truth once it's here
+	if (const UClass* ActionClass = GetActionClass()) {
+		return FSoftObjectPath(ActionClass->GetDefaultObject<UContext_Action>()->PayloadClass.Get());
+	}
+
+	if (!IsActionPayloadClassKnown()) {
+		UE_LOG(LogContextSubsystem, Verbose, TEXT("Entry %ls has no recorded payload class and its action isn't loaded, resave it"),
+			*GetName());
+	}
+	return ActionPayloadClass.ToSoftObjectPath();
+}
+
+bool UContext_ActionEntry::IsActionPayloadClassKnown() const {
+	return Action.IsNull() || bActionPayloadClassRecorded || GetActionClass() != nullptr;
+}
+
+void UContext_ActionEntry::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	if (!Action.IsNull()) {
+		OutAssets.Add(Action.ToSoftObjectPath());
+	}
+
+	for (const UContext_ActionValidation* Validation : Validations) {
+		if (IsValid(Validation)) {
+			Validation->GetStreamedAssets(OutAssets);
+		}
+	}
+}
 
 bool UContext_ActionEntry::RunActionValidations(AActor* Caller, AActor* ContextOwner) const {
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_RunValidations);
+	INC_DWORD_STAT(STAT_Context_NumValidationRuns);
+	TRACE_COUNTER_INCREMENT(Context_ValidationRuns);
+	
+	if (!ValidationPlan.bCompiled) {
+		CompileValidationPlan();
+	}
 
-	for (const auto Validation : Validations) {
+	for (UContext_ActionValidation* Validation : ValidationPlan.Blocking) {
 		if (!Validation->RunValidation(Caller, ContextOwner)) {
 			return false;
 		}
 	}
 
+	// Only run for their results
+	for (UContext_ActionValidation* Validation : ValidationPlan.NonBlocking) {
+		Validation->RunValidation(Caller, ContextOwner);
+	}
+
 	return true;
 }
+
+void UContext_ActionEntry::CompileValidationPlan() const {
+	ValidationPlan.Blocking.Reset();
+	ValidationPlan.NonBlocking.Reset();
+
+	for (UContext_ActionValidation* Validation : Validations) {
+		if (!IsValid(Validation)) continue;
+
+		if (Validation->GetValidationSeverity() == AllowFail) {
+			ValidationPlan.NonBlocking.Add(Validation);
+		} else {
+			ValidationPlan.Blocking.Add(Validation);
+		}
+	}
+
+	// Stable, so validations of the same cost keep their authoring order
+	ValidationPlan.Blocking.StableSort([](const UContext_ActionValidation& A, const UContext_ActionValidation& B) {
+		return A.GetValidationCost() < B.GetValidationCost();
+	});
+	
+	ValidationPlan.bCompiled = true;
+}
+
+void UContext_ActionEntry::GetPayloadFunctionNames(FName& OutDisplayName, FName& OutExpectedName) const {
+	if (PayloadFunctionExpectedName.IsNone()) {
+		FString Identifier;
+		if (!PayloadId.IsNone()) {
+			Identifier = PayloadId.ToString();
+		} else {
+			// Source string rather than ActionName.ToString(), which would be the localized display string
+			const FString* SourceString = FTextInspector::GetSourceString(ActionName);
+			Identifier = SourceString ? *SourceString : ActionName.ToString();
+		}
+
+		// really funky, but it basically just copies how blueprint functions are named by default
+		const FString FunctionNameBase = FString::Printf(TEXT("GetPayload_%s"), *Identifier);
+		PayloadFunctionDisplayName = FName(FName::NameToDisplayString(FunctionNameBase, false));
+		PayloadFunctionExpectedName = FName(FunctionNameBase);
+	}
+
+	OutDisplayName = PayloadFunctionDisplayName;
+	OutExpectedName = PayloadFunctionExpectedName;
+}
+
+#if WITH_EDITOR
+void UContext_ActionEntry::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Validations may have been added, removed or edited, recompile on next use
+	ValidationPlan.bCompiled = false;
+	
+	const FName PropertyName = PropertyChangedEvent.GetPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UContext_ActionEntry, PayloadId)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(UContext_ActionEntry, ActionName)) {
+		PayloadFunctionDisplayName = NAME_None;
+		PayloadFunctionExpectedName = NAME_None;
+		FContext_PayloadFunctionTable::Reset();
+	}
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UContext_ActionEntry, Action)) {
+		RecordActionPayloadClass();
+	}
+
+	// Edits inside a tag container report the container's inner property, so check the member
+	const FName MemberPropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (GEngine && (MemberPropertyName == GET_MEMBER_NAME_CHECKED(UContext_ActionEntry, RequiredTags)
+		|| MemberPropertyName == GET_MEMBER_NAME_CHECKED(UContext_ActionEntry, BlockingTags))) {
+		// Every game instance playing may have compiled the old tags
+		for (const FWorldContext& WorldContext : GEngine->GetWorldContexts()) {
+			const UGameInstance* GameInstance = WorldContext.OwningGameInstance;
+			if (UContext_ActionSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UContext_ActionSubsystem>() : nullptr) {
+				Subsystem->NotifyEntryTagsChanged(this);
+			}
+		}
+	}
+}
+
+void UContext_ActionEntry::PreSave(FObjectPreSaveContext ObjectSaveContext) {
+	// The action's payload class may have changed since the entry was edited
+	RecordActionPayloadClass();
+	
+	Super::PreSave(ObjectSaveContext);
+}
+
+void UContext_ActionEntry::RecordActionPayloadClass() {
+	const UClass* ActionClass = Action.IsNull() ? nullptr : Action.LoadSynchronous();
+	ActionPayloadClass = ActionClass ? ActionClass->GetDefaultObject<UContext_Action>()->PayloadClass.Get() : nullptr;
+	bActionPayloadClassRecorded = ActionClass != nullptr;
+}
+#endif
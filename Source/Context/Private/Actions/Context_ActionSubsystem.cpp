@@ -4,17 +4,91 @@
 #include "Actions/Context_ActionSubsystem.h"
 
 #include "Context_ActionPayloadBase.h"
+#include "Context_Settings.h"
+#include "Context_Stats.h"
 #include "Actions/Context_Action.h"
 #include "Actions/Context_ActionEntry.h"
+#include "Async/ParallelFor.h"
+#include "Blueprint/UserWidget.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "Interface/Context_Giver.h"
 #include "Interface/Context_Holder.h"
+#include "Misc/MemStack.h"
 #include "UI/Context_Menu.h"
 #include "UI/Context_UIWidgetBase.h"
 
+void UContext_ActionSubsystem::Initialize(FSubsystemCollectionBase& Collection) {
+	Super::Initialize(Collection);
+
+	// Load the menu in the background and build it before anyone asks for it
+	const TSoftClassPtr<UContext_Menu>& MenuClass = GetDefault<UContext_Settings>()->ContextMenuClass;
+	if (!MenuClass.IsNull()) {
+		ContextMenuLoadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			MenuClass.ToSoftObjectPath(),
+			FStreamableDelegate::CreateWeakLambda(this, [this, MenuClass]() {
+				// A system component's ContextMenuTemplate wins, even if it was built before we finished loading
+				if (!IsValid(ContextMenu)) {
+					PrewarmContextMenu(MenuClass.Get());
+				}
+				ContextMenuLoadHandle.Reset();
+			}));
+	}
+}
+
+void UContext_ActionSubsystem::Deinitialize() {
+	if (ContextMenuLoadHandle.IsValid()) {
+		ContextMenuLoadHandle->CancelHandle();
+		ContextMenuLoadHandle.Reset();
+	}
+	ReleaseEntryAssets();
+
+	// Ability systems may outlive us, stop them calling into the index
+	ValidationMemo.Reset();
+	AbilitySystemIndex.Reset();
+	
+	Super::Deinitialize();
+}
+
 void UContext_ActionSubsystem::SetContextMenuInstance(UContext_Menu* ContextMenuInstance) {
 	ContextMenu = ContextMenuInstance;
 }
 
+void UContext_ActionSubsystem::PrewarmContextMenu(const TSubclassOf<UContext_Menu> MenuClass) {
+	if (!MenuClass || (IsValid(ContextMenu) && ContextMenu->GetClass() == MenuClass)) return;
+
+	UContext_Menu* Menu = CreateWidget<UContext_Menu>(GetGameInstance(), MenuClass);
+	if (!Menu) return;
+
+	// Building the Slate widgets now is what makes the first open cheap, the menu is only shown once it has an owner
+	Menu->SetVisibility(ESlateVisibility::Collapsed);
+	Menu->PrewarmEntryButtons(GetDefault<UContext_Settings>()->PrewarmedEntryButtons);
+	Menu->TakeWidget();
+
+	if (IsValid(ContextMenu)) {
+		ContextMenu->RemoveFromParent();
+	}
+	ContextMenu = Menu;
+	
+	// The owner may have been given before the menu existed, or to the menu being replaced
+	if (APlayerController* Owner = ContextMenuOwner.Get()) {
+		SetContextMenuOwner(Owner);
+	}
+}
+
+void UContext_ActionSubsystem::SetContextMenuOwner(APlayerController* PlayerController) {
+	if (!IsValid(PlayerController)) return;
+
+	// Remembered for menus built later
+	ContextMenuOwner = PlayerController;
+	if (!IsValid(ContextMenu)) return;
+
+	ContextMenu->SetOwningPlayer(PlayerController);
+	if (!ContextMenu->IsInViewport()) {
+		ContextMenu->AddToViewport();
+	}
+}
+
 void UContext_ActionSubsystem::DisableContextSource(const EContext_ContextSource Source) {
 	EnabledSources &= ~Source;
 }
@@ -31,24 +105,64 @@ void UContext_ActionSubsystem::ShowContextMenu(
 	const TArray<FContextEntryPackage>& ContextEntries,
 	const FVector WorldPosition) {
 
-	if (!IsValid(ContextMenu)) return;
-
 	// Prevent opening context for actors (world objects) if world context is disabled
-	if (!CheckSourceEnabled(EContext_ContextSource::World)) return;
+	if (!IsValid(ContextMenu) || !CheckSourceEnabled(EContext_ContextSource::World)) {
+		ConsumeMenuOpenRequest();
+		return;
+	}
 
+	StreamEntryAssetsForPackages(ContextEntries);
+	ResolvePayloadsForPackages(ContextEntries);
 	ContextMenu->ShowMenu(WorldPosition, ContextEntries);
 }
 
 void UContext_ActionSubsystem::ShowUIContextMenu(
 	const FVector2D ScreenPosition,
 	const TArray<FContextEntryPackage>& ContextEntries) {
-	if (!CheckSourceEnabled(EContext_ContextSource::UI) || !UIContextElement.IsValid()) return;
+	const APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController();
+	if (!CheckSourceEnabled(EContext_ContextSource::UI) || !UIContextElement.IsValid() || !IsValid(ContextMenu) || !IsValid(PC)) {
+		ConsumeMenuOpenRequest();
+		return;
+	}
+	
+	StreamEntryAssetsForPackages(ContextEntries);
+	ResolvePayloadsForPackages(ContextEntries);
+	ContextMenu->ShowMenuScreenSpace(ScreenPosition, ContextEntries, false);
+}
+
+void UContext_ActionSubsystem::StreamEntryAssets(const UContext_ActionEntry* Entry) {
+	if (!IsValid(Entry) || EntryAssetHandles.Contains(Entry)) return;
 
-	if (const APlayerController* PC = GetGameInstance()->GetFirstLocalPlayerController(); IsValid(PC)) {
-		ContextMenu->ShowMenuScreenSpace(ScreenPosition, ContextEntries, false);
+	TArray<FSoftObjectPath> Assets;
+	Entry->GetStreamedAssets(Assets);
+
+	// Nothing to stream, or everything is loaded already. Remember it anyway so we don't check again
+	Assets.RemoveAll([](const FSoftObjectPath& Asset) { return Asset.ResolveObject() != nullptr; });
+	if (Assets.IsEmpty()) {
+		EntryAssetHandles.Add(Entry, nullptr);
+		return;
+	}
+
+	EntryAssetHandles.Add(Entry, UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Assets)));
+}
+
+void UContext_ActionSubsystem::StreamEntryAssetsForPackages(const TArray<FContextEntryPackage>& ContextEntries) {
+	for (const FContextEntryPackage& Package : ContextEntries) {
+		for (const UContext_ActionEntry* Entry : Package.ContextEntries) {
+			StreamEntryAssets(Entry);
+		}
 	}
 }
 
+void UContext_ActionSubsystem::ReleaseEntryAssets() {
+	for (const TPair<TObjectKey<UContext_ActionEntry>, TSharedPtr<FStreamableHandle>>& Pair : EntryAssetHandles) {
+		if (Pair.Value.IsValid()) {
+			Pair.Value->ReleaseHandle();
+		}
+	}
+	EntryAssetHandles.Empty();
+}
+
 void UContext_ActionSubsystem::HideContextMenu() {
 	if (!IsValid(ContextMenu)) return;
 	ContextMenu->HideMenu();
@@ -72,21 +186,216 @@ bool UContext_ActionSubsystem::ExecuteAction(TScriptInterface<IContext_Holder> C
 		return false;
 	}
 	
-	const UContext_ActionPayloadBase* Payload = ContextObject->Execute_RequestPayload(ContextObject.GetObject(), Action);
-	UContext_Action* ContextAction = NewObject<UContext_Action>(ContextObject.GetObject(), Action->Action);
-	ContextAction->InstigatorActor = InstigatorActor;
+	const UContext_ActionPayloadBase* Payload = GetPayloadForEntry(ContextObject, Action);
+
+	// Actions on components act on the owning actor
+	UObject* ExecutionTarget = ContextObject.GetObject();
+	if (const UActorComponent* Component = Cast<UActorComponent>(ExecutionTarget)) {
+		ExecutionTarget = Component->GetOwner();
+	}
+
+	// Normally streamed in when the entry was shown
+	const TSubclassOf<UContext_Action> ActionClass = Action->LoadActionClass();
+	const UContext_Action* ActionDefaults = ActionClass.GetDefaultObject();
+	if (!IsValid(ActionDefaults)) {
+		return false;
+	}
 	
-	const UActorComponent* Component = Cast<UActorComponent>(ContextObject.GetObject());
-	if (IsValid(Component)) {
-		return ContextAction->ExecuteContextAction(Component->GetOwner(), Payload);
+	switch (ActionDefaults->ExecutionMode) {
+	case EContext_ActionExecutionMode::Stateless: {
+		FContext_ActionExecutionContext ExecutionContext;
+		ExecutionContext.InstigatorActor = InstigatorActor;
+		ExecutionContext.ContextHolder = ContextObject.GetObject();
+		
+		// The class default object isn't in any world, so it gets the holder's
+		ExecutionContext.World = ExecutionTarget ? ExecutionTarget->GetWorld() : nullptr;
+		if (!ExecutionContext.World) {
+			ExecutionContext.World = GetWorld();
+		}
+		return ActionDefaults->ExecuteStatelessContextAction(ExecutionContext, ExecutionTarget, Payload);
+	}
+		
+	case EContext_ActionExecutionMode::Pooled: {
+		UContext_Action* ContextAction = AcquirePooledAction(ActionClass);
+		ContextAction->InstigatorActor = InstigatorActor;
+		
+		const bool bExecuted = ContextAction->ExecuteContextAction(ExecutionTarget, Payload);
+		ReleasePooledAction(ContextAction);
+		return bExecuted;
 	}
-	return ContextAction->ExecuteContextAction(ContextObject.GetObject(), Payload);
+		
+	default: {
+		UContext_Action* ContextAction = nullptr;
+		{
+			CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_CreateAction);
+			INC_DWORD_STAT(STAT_Context_NumActionsCreated);
+			TRACE_COUNTER_INCREMENT(Context_ActionsCreated);
+			ContextAction = NewObject<UContext_Action>(ContextObject.GetObject(), ActionClass);
+		}
+		ContextAction->InstigatorActor = InstigatorActor;
+		return ContextAction->ExecuteContextAction(ExecutionTarget, Payload);
+	}
+	}
+}
+
+UContext_Action* UContext_ActionSubsystem::AcquirePooledAction(const TSubclassOf<UContext_Action> ActionClass) {
+	UContext_Action* ContextAction = nullptr;
+	
+	FContext_ActionPool* Pool = ActionPools.Find(ActionClass);
+	while (Pool && !ContextAction && Pool->IdleActions.Num() > 0) {
+		ContextAction = Pool->IdleActions.Pop();
+		if (!IsValid(ContextAction)) ContextAction = nullptr;
+	}
+
+	// Pooled actions outlive any single holder, so they're outered to the game instance
+	if (!ContextAction) {
+		CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_CreateAction);
+		INC_DWORD_STAT(STAT_Context_NumActionsCreated);
+		TRACE_COUNTER_INCREMENT(Context_ActionsCreated);
+		ContextAction = NewObject<UContext_Action>(GetGameInstance(), ActionClass);
+	}
+
+	ContextAction->OnAcquiredFromPool();
+	return ContextAction;
+}
+
+void UContext_ActionSubsystem::ReleasePooledAction(UContext_Action* ContextAction) {
+	if (!IsValid(ContextAction)) return;
+
+	ContextAction->OnReleasedToPool();
+
+	FContext_ActionPool& Pool = ActionPools.FindOrAdd(ContextAction->GetClass());
+	if (Pool.IdleActions.Num() < GetDefault<UContext_Settings>()->MaxPooledActionsPerClass) {
+		Pool.IdleActions.Add(ContextAction);
+	}
+}
+
+const UContext_ActionPayloadBase* UContext_ActionSubsystem::GetPayloadForEntry(
+	TScriptInterface<IContext_Holder> ContextObject,
+	const UContext_ActionEntry* Entry) {
+
+	const UObject* ContextHolder = ContextObject.GetObject();
+	if (!IsValid(ContextHolder) || !IsValid(Entry)) {
+		return nullptr;
+	}
+
+	const UContext_ActionPayloadBase* Payload = nullptr;
+	if (FindCachedPayload(ContextHolder, Entry, Payload)) {
+		return Payload;
+	}
+
+	Payload = IContext_Holder::Execute_RequestPayload(ContextHolder, Entry);
+	StoreCachedPayload(ContextHolder, Entry, Payload);
+	return Payload;
+}
+
+void UContext_ActionSubsystem::ResolvePayloadsForPackages(const TArray<FContextEntryPackage>& ContextEntries) {
+	if (GetDefault<UContext_Settings>()->PayloadCacheMode == EContext_PayloadCacheMode::Disabled) {
+		return;
+	}
+
+	TMap<const UFunction*, const UContext_ActionPayloadBase*, TInlineSetAllocator<8>> PayloadsByFunction;
+	for (const FContextEntryPackage& Package : ContextEntries) {
+		const UObject* ContextHolder = Package.ContextHolder.GetObject();
+		if (!IsValid(ContextHolder)) continue;
+
+		// Payloads are only shared within a holder
+		const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+		PayloadsByFunction.Reset();
+		
+		for (const UContext_ActionEntry* Entry : Package.ContextEntries) {
+			// Actions still streaming in are resolved when executed instead
+			const UClass* ActionClass = IsValid(Entry) ? Entry->GetActionClass() : nullptr;
+			if (!ActionClass) continue;
+
+			// Entries without a payload class have nothing to resolve
+			const UClass* PayloadClass = ActionClass->GetDefaultObject<UContext_Action>()->PayloadClass;
+			if (!PayloadClass) continue;
+
+			// Payloads come from per entry functions, so only entries calling the same one can share it
+			const UFunction* PayloadFunction = Holder ? Holder->GetPayloadFunction(Entry) : nullptr;
+
+			const UContext_ActionPayloadBase* Payload = nullptr;
+			if (FindCachedPayload(ContextHolder, Entry, Payload)) {
+				if (PayloadFunction) {
+					PayloadsByFunction.Add(PayloadFunction, Payload);
+				}
+				continue;
+			}
+
+			const UContext_ActionPayloadBase* const* SharedPayload =
+				PayloadFunction ? PayloadsByFunction.Find(PayloadFunction) : nullptr;
+			if (SharedPayload) {
+				Payload = *SharedPayload;
+			} else {
+				Payload = IContext_Holder::Execute_RequestPayload(ContextHolder, Entry);
+				if (PayloadFunction) {
+					PayloadsByFunction.Add(PayloadFunction, Payload);
+				}
+			}
+			
+			StoreCachedPayload(ContextHolder, Entry, Payload);
+		}
+	}
+}
+
+bool UContext_ActionSubsystem::FindCachedPayload(
+	const UObject* ContextHolder,
+	const UContext_ActionEntry* Entry,
+	const UContext_ActionPayloadBase*& OutPayload) const {
+
+	const EContext_PayloadCacheMode CacheMode = GetDefault<UContext_Settings>()->PayloadCacheMode;
+	if (CacheMode == EContext_PayloadCacheMode::Disabled) {
+		return false;
+	}
+
+	const FContext_HolderPayloads* HolderPayloads = PayloadCache.Find(ContextHolder);
+	const FContext_CachedPayload* Cached = HolderPayloads ? HolderPayloads->Find(Entry) : nullptr;
+	if (!Cached) {
+		return false;
+	}
+
+	const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+	const uint32 HolderVersion = Holder ? Holder->GetContextVersion() : 0;
+	
+	// Unversioned holders can't tell us they've changed, so they only reuse payloads within a frame
+	const bool bSameFrame = Cached->Frame == GFrameCounter;
+	if (CacheMode == EContext_PayloadCacheMode::Frame || HolderVersion == 0) {
+		if (!bSameFrame) return false;
+	}
+	
+	if (Cached->HolderVersion != HolderVersion) {
+		return false;
+	}
+
+	OutPayload = Cached->Payload;
+	return true;
+}
+
+void UContext_ActionSubsystem::StoreCachedPayload(
+	const UObject* ContextHolder,
+	const UContext_ActionEntry* Entry,
+	const UContext_ActionPayloadBase* Payload) {
+
+	if (GetDefault<UContext_Settings>()->PayloadCacheMode == EContext_PayloadCacheMode::Disabled) {
+		return;
+	}
+
+	const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+	
+	FContext_CachedPayload& Cached = PayloadCache.FindOrAdd(ContextHolder).FindOrAdd(Entry);
+	Cached.Payload = Payload;
+	Cached.HolderVersion = Holder ? Holder->GetContextVersion() : 0;
+	Cached.Frame = GFrameCounter;
 }
 
 bool UContext_ActionSubsystem::CanExecuteEntry(
 	const UObject* ContextObject,
 	const UContext_ActionEntry* Entry) const {
 
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_CanExecuteEntry);
+	INC_DWORD_STAT(STAT_Context_NumEntryChecks);
+	
 	if(!IsValid(Entry)) {
 		UE_LOG(LogContextSubsystem, Warning, TEXT("Invalid context entry passed to Action Subsystem"));
 		return false;
@@ -100,15 +409,43 @@ bool UContext_ActionSubsystem::CanExecuteEntry(
 	if (!IsValid(ContextHolder)) {
 		return false;
 	}
+
+	// Compiling first registers the entry's tags, so holders filtering tag changes are up to date when asked for tags
+	TagIndex.CompileEntry(Entry);
 	
-	// If tags don't match (Similarly to abilities in gas) then the entry cannot be executed
-	FGameplayTagContainer Tags;
-	Cast<IContext_Holder>(ContextHolder)->GetOwnedGameplayTags(Tags);
+	FGameplayTagContainer Scratch;
+	const FGameplayTagContainer& Tags = GetHolderTags(Cast<IContext_Holder>(ContextHolder), Scratch);
 	
-	if (Tags.HasAny(Entry->BlockingTags) || !Tags.HasAllExact(Entry->RequiredTags)) {
+	return CanExecuteEntryWithTags(Tags, Entry);
+}
+
+const FGameplayTagContainer& UContext_ActionSubsystem::GetHolderTags(
+	const IContext_Holder* Holder,
+	FGameplayTagContainer& Scratch) {
+
+	if (!Holder) {
+		return Scratch;
+	}
+	
+	if (const FGameplayTagContainer* View = Holder->GetOwnedGameplayTagsView()) {
+		return *View;
+	}
+
+	Holder->GetOwnedGameplayTags(Scratch);
+	return Scratch;
+}
+
+bool UContext_ActionSubsystem::CanExecuteEntryWithTags(
+	const FGameplayTagContainer& Tags,
+	const UContext_ActionEntry* Entry) const {
+
+	if(!IsValid(Entry)) {
+		UE_LOG(LogContextSubsystem, Warning, TEXT("Invalid context entry passed to Action Subsystem"));
 		return false;
 	}
-	return true;
+	
+	// If tags don't match (Similarly to abilities in gas) then the entry cannot be executed
+	return FContext_TagIndex::MatchesContainers(Tags, Entry->RequiredTags, Entry->BlockingTags);
 }
 
 UObject* UContext_ActionSubsystem::RetrieveValidContextHolderFromObjectNonConst(UObject* ContextObjectRoot) const {
@@ -120,10 +457,7 @@ UObject* UContext_ActionSubsystem::RetrieveValidContextHolderFromObjectNonConst(
 	const AActor* Actor = Cast<AActor>(ContextObjectRoot);  
 	if (IsValid(Actor)) {
 		// return first component found
-		TArray<UActorComponent*> Comps = Actor->GetComponentsByInterface(UContext_Holder::StaticClass());
-		if (Comps.Num() > 0) {
-			return Comps[0];
-		}
+		return Actor->FindComponentByInterface(UContext_Holder::StaticClass());
 	}
 
 	return nullptr;
@@ -138,10 +472,7 @@ const UObject* UContext_ActionSubsystem::RetrieveValidContextHolderFromObject(co
 	const AActor* Actor = Cast<AActor>(ContextObjectRoot);  
 	if (IsValid(Actor)) {
 		// return first component found
-		TArray<UActorComponent*> Comps = Actor->GetComponentsByInterface(UContext_Holder::StaticClass());
-		if (Comps.Num() > 0) {
-			return Comps[0];
-		}
+		return Actor->FindComponentByInterface(UContext_Holder::StaticClass());
 	}
 
 	return nullptr;
@@ -150,25 +481,337 @@ const UObject* UContext_ActionSubsystem::RetrieveValidContextHolderFromObject(co
 TSet<UContext_ActionEntry*> UContext_ActionSubsystem::GetValidContextEntriesForObject(
 	const UObject* ContextObject) const {
 
-	// Get the exact object that holds the context interface, and return an empty set if none.
+	TArray<UContext_ActionEntry*> ValidEntries;
+	CollectValidContextEntries(ContextObject, ValidEntries);
+
+	TSet<UContext_ActionEntry*> Entries;
+	Entries.Append(ValidEntries);
+	return Entries;
+}
+
+void UContext_ActionSubsystem::CollectValidContextEntries(
+	const UObject* ContextObject,
+	TArray<UContext_ActionEntry*>& OutEntries) const {
+
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_GetValidEntries);
+	INC_DWORD_STAT(STAT_Context_NumEntryQueries);
+	TRACE_COUNTER_INCREMENT(Context_EntryQueries);
+	
+	OutEntries.Reset();
+	
+	// Get the exact object that holds the context interface, and return no entries if none.
 	const UObject* ContextHolder = RetrieveValidContextHolderFromObject(ContextObject);
 	if (!ensure(ContextHolder)) {
-		return TSet<UContext_ActionEntry*>();
+		return;
+	}
+
+	// Nothing changed since the last query, reuse the last result
+	FContext_TreeVersion TreeVersion;
+	GetContextTreeVersion(ContextHolder, TreeVersion);
+	if (const FContext_ValidEntryCache* Cached = FindValidEntryCache(ContextHolder, TreeVersion)) {
+		OutEntries.Append(Cached->ValidEntries);
+		return;
+	}
+
+	ResolveValidContextEntries(ContextHolder, OutEntries);
+	StoreValidEntryCache(ContextHolder, TreeVersion, OutEntries);
+}
+
+const FContext_ValidEntryCache* UContext_ActionSubsystem::FindValidEntryCache(
+	const UObject* ContextHolder,
+	const FContext_TreeVersion& TreeVersion) const {
+
+	if (!TreeVersion.IsVersioned()) {
+		return nullptr;
+	}
+	
+	const FContext_ValidEntryCache* Cached = ValidEntryCache.Find(ContextHolder);
+	if (Cached
+		&& Cached->TreeVersion == TreeVersion
+		&& Cached->GiverEpoch == GiverEpoch
+		&& Cached->TreeEpoch == TreeEpoch) {
+		return Cached;
+	}
+	return nullptr;
+}
+
+void UContext_ActionSubsystem::StoreValidEntryCache(
+	const UObject* ContextHolder,
+	const FContext_TreeVersion& TreeVersion,
+	const TConstArrayView<UContext_ActionEntry*> ValidEntries) const {
+
+	// Resolving calls into Blueprint, which may have touched the cache, so only grab the cache entry now
+	if (TreeVersion.IsVersioned()) {
+		FContext_ValidEntryCache& Cached = ValidEntryCache.FindOrAdd(ContextHolder);
+		Cached.TreeVersion = TreeVersion;
+		Cached.GiverEpoch = GiverEpoch;
+		Cached.TreeEpoch = TreeEpoch;
+		Cached.ValidEntries.Reset();
+		Cached.ValidEntries.Append(ValidEntries.GetData(), ValidEntries.Num());
+	}
+}
+
+template <typename AllocatorType>
+void UContext_ActionSubsystem::GatherRawContextEntries(
+	const UObject* ContextHolder,
+	TArray<UContext_ActionEntry*, AllocatorType>& OutEntries) const {
+
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_TreeAggregation);
+
+	// Holder entries are already unique
+	const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+	if (const TSet<UContext_ActionEntry*>* HolderEntries = Holder ? Holder->GetActionEntriesView() : nullptr) {
+		OutEntries.Reserve(OutEntries.Num() + HolderEntries->Num());
+		for (UContext_ActionEntry* Entry : *HolderEntries) {
+			OutEntries.Add(Entry);
+		}
+	} else {
+		for (UContext_ActionEntry* Entry : IContext_Holder::Execute_GetActionEntries(ContextHolder)) {
+			OutEntries.Add(Entry);
+		}
+	}
+
+	FContext_GiverLinkArray Givers;
+	GetGiverChain(ContextHolder, DefaultTreeDepth, Givers);
+	if (Givers.IsEmpty()) {
+		return;
+	}
+
+	// Givers may pass down entries the holder or another giver already has
+	TSet<const UContext_ActionEntry*, DefaultKeyFuncs<const UContext_ActionEntry*>, TInlineSetAllocator<64>> SeenEntries;
+	SeenEntries.Reserve(OutEntries.Num());
+	for (const UContext_ActionEntry* Entry : OutEntries) {
+		SeenEntries.Add(Entry);
+	}
+	
+	for (const FContext_GiverLink& Link : Givers) {
+		UObject* Giver = Link.Giver.Get();
+		if (!IsValid(Giver)) continue;
+
+		for (UContext_ActionEntry* Entry : GetGiverEntries(Giver)) {
+			bool bAlreadySeen = false;
+			SeenEntries.Add(Entry, &bAlreadySeen);
+			if (!bAlreadySeen) {
+				OutEntries.Add(Entry);
+			}
+		}
 	}
+}
+
+void UContext_ActionSubsystem::ResolveValidContextEntries(
+	const UObject* ContextHolder,
+	TArray<UContext_ActionEntry*>& OutValidEntries) const {
 
+	// Scratch memory only lives for this resolve
+	FMemMark Mark(FMemStack::Get());
+	
 	// Get all raw entries
-	TSet<UContext_ActionEntry*> Entries = IContext_Holder::Execute_GetActionEntries(ContextHolder);
-	Entries.Append(AggregateContextEntriesInTree(ContextHolder));
+	TArray<UContext_ActionEntry*, TMemStackAllocator<>> Entries;
+	GatherRawContextEntries(ContextHolder, Entries);
 
-	// Only keep the valid entries - Checks tags
-	TSet<UContext_ActionEntry*> ValidEntries;
+	// Compile every entry before building the holder's masks, compiling may grow the tag index
+	TArray<UContext_ActionEntry*, TMemStackAllocator<>> Candidates;
+	TArray<FContext_CompiledEntryTags, TMemStackAllocator<>> CandidateTags;
+	Candidates.Reserve(Entries.Num());
+	CandidateTags.Reserve(Entries.Num());
 	for (auto Entry : Entries) {
-		if (CanExecuteEntry(ContextHolder, Entry)) {
-			ValidEntries.Add(Entry);
+		if(!IsValid(Entry)) {
+			UE_LOG(LogContextSubsystem, Warning, TEXT("Invalid context entry passed to Action Subsystem"));
+			continue;
 		}
+		
+		Candidates.Add(Entry);
+		CandidateTags.Add(TagIndex.CompileEntry(Entry));
 	}
+
+	// Tags are the same for every entry, only fetch them once. Fetched after compiling, see CanExecuteEntry
+	FGameplayTagContainer Scratch;
+	const FGameplayTagContainer& Tags = GetHolderTags(Cast<IContext_Holder>(ContextHolder), Scratch);
+
+	FContext_HolderTagMasks HolderMasks;
+	TagIndex.BuildHolderMasks(Tags, HolderMasks);
+
+	// Only keep the valid entries - Checks tags
+	OutValidEntries.Reset();
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index) {
+		const FContext_CompiledEntryTags& EntryTags = CandidateTags[Index];
+		const bool bValid = EntryTags.bRequiresFallback ?
+			CanExecuteEntryWithTags(Tags, Candidates[Index]) :
+			FContext_TagIndex::Matches(HolderMasks, EntryTags);
+		
+		if (bValid) {
+			OutValidEntries.Add(Candidates[Index]);
+		}
+	}
+}
+
+void UContext_ActionSubsystem::GetContextEntryPackagesForObjects(
+	const TConstArrayView<UObject*> ContextObjects,
+	const TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+	TArray<FContextEntryPackage>& OutPackages) const {
+
+	OutPackages.Reset(ContextObjects.Num());
+
+	// Default entries are the same for every holder, only build them once
+	TSet<UContext_ActionEntry*> Defaults;
+	Defaults.Append(DefaultEntries);
+
+	// Multiple objects (a hit component and its actor, for example) may resolve to the same holder
+	TSet<const UObject*, DefaultKeyFuncs<const UObject*>, TInlineSetAllocator<64>> VisitedHolders;
+
+	// Shared between every holder so it only grows once
+	TArray<UContext_ActionEntry*> ValidEntries;
 	
-	return ValidEntries;
+	for (UObject* ContextObject : ContextObjects) {
+		if (!IsValid(ContextObject)) continue;
+		
+		UObject* ContextHolder = RetrieveValidContextHolderFromObjectNonConst(ContextObject);
+		if (!IsValid(ContextHolder)) continue;
+
+		bool bAlreadyVisited = false;
+		VisitedHolders.Add(ContextHolder, &bAlreadyVisited);
+		if (bAlreadyVisited) continue;
+		
+		CollectValidContextEntries(ContextHolder, ValidEntries);
+		
+		TSet<UContext_ActionEntry*> ActionEntries;
+		ActionEntries.Reserve(ValidEntries.Num() + Defaults.Num());
+		ActionEntries.Append(ValidEntries);
+		ActionEntries.Append(Defaults);
+
+		OutPackages.Add(FContextEntryPackage(ContextHolder, MoveTemp(ActionEntries)));
+	}
+}
+
+void UContext_ActionSubsystem::EvaluateContextPackagesParallel(
+	const TConstArrayView<UObject*> ContextObjects,
+	const TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+	TArray<FContextEntryPackage>& OutPackages) const {
+
+	check(IsInGameThread());
+	
+	OutPackages.Reset(ContextObjects.Num());
+
+	// Plain data snapshot of a single holder. Entries live in the flat arrays below, in [FirstEntry, FirstEntry + NumEntries)
+	struct FHolderSnapshot {
+		UObject* ContextHolder = nullptr;
+		FContext_TreeVersion TreeVersion;
+		bool bFromCache = false;
+		int32 FirstEntry = 0;
+		int32 NumEntries = 0;
+		FGameplayTagContainer Tags;
+		FContext_HolderTagMasks Masks;
+	};
+
+	TArray<FHolderSnapshot> Snapshots;
+	TArray<UContext_ActionEntry*> SnapshotEntries;
+	TArray<FContext_CompiledEntryTags> SnapshotEntryTags;
+	Snapshots.Reserve(ContextObjects.Num());
+
+	// Multiple objects (a hit component and its actor, for example) may resolve to the same holder
+	TSet<const UObject*> VisitedHolders;
+	VisitedHolders.Reserve(ContextObjects.Num());
+
+	////////
+	/// ~SNAPSHOT - game thread. Everything touching UObjects or Blueprint happens here
+	{
+		FMemMark Mark(FMemStack::Get());
+		TArray<UContext_ActionEntry*, TMemStackAllocator<>> RawEntries;
+		
+		for (UObject* ContextObject : ContextObjects) {
+			if (!IsValid(ContextObject)) continue;
+			
+			UObject* ContextHolder = RetrieveValidContextHolderFromObjectNonConst(ContextObject);
+			if (!IsValid(ContextHolder)) continue;
+
+			bool bAlreadyVisited = false;
+			VisitedHolders.Add(ContextHolder, &bAlreadyVisited);
+			if (bAlreadyVisited) continue;
+
+			const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+			
+			FHolderSnapshot& Snapshot = Snapshots.AddDefaulted_GetRef();
+			Snapshot.ContextHolder = ContextHolder;
+			GetContextTreeVersion(ContextHolder, Snapshot.TreeVersion);
+			Snapshot.FirstEntry = SnapshotEntries.Num();
+
+			// Already valid entries don't need filtering
+			if (const FContext_ValidEntryCache* Cached = FindValidEntryCache(ContextHolder, Snapshot.TreeVersion)) {
+				Snapshot.bFromCache = true;
+				Snapshot.NumEntries = Cached->ValidEntries.Num();
+				SnapshotEntries.Append(Cached->ValidEntries);
+				SnapshotEntryTags.AddDefaulted(Snapshot.NumEntries);
+				continue;
+			}
+
+			RawEntries.Reset();
+			GatherRawContextEntries(ContextHolder, RawEntries);
+			for (UContext_ActionEntry* Entry : RawEntries) {
+				if (!IsValid(Entry)) continue;
+				
+				SnapshotEntries.Add(Entry);
+				SnapshotEntryTags.Add(TagIndex.CompileEntry(Entry));
+			}
+			Snapshot.NumEntries = SnapshotEntries.Num() - Snapshot.FirstEntry;
+
+			if (Holder) {
+				Holder->GetOwnedGameplayTags(Snapshot.Tags);
+			}
+		}
+
+		// Every entry is compiled now, so the tag index won't grow anymore
+		for (FHolderSnapshot& Snapshot : Snapshots) {
+			if (!Snapshot.bFromCache) {
+				TagIndex.BuildHolderMasks(Snapshot.Tags, Snapshot.Masks);
+			}
+		}
+	}
+
+	////////
+	/// ~FILTER - task threads. Plain data only, no UObject access beyond reading entry tags for fallback entries
+	TArray<bool> EntryIsValid;
+	EntryIsValid.SetNumZeroed(SnapshotEntries.Num());
+	
+	ParallelFor(Snapshots.Num(), [&](const int32 SnapshotIndex) {
+		const FHolderSnapshot& Snapshot = Snapshots[SnapshotIndex];
+		for (int32 Index = Snapshot.FirstEntry; Index < Snapshot.FirstEntry + Snapshot.NumEntries; ++Index) {
+			if (Snapshot.bFromCache) {
+				EntryIsValid[Index] = true;
+				continue;
+			}
+			
+			const FContext_CompiledEntryTags& EntryTags = SnapshotEntryTags[Index];
+			EntryIsValid[Index] = EntryTags.bRequiresFallback ?
+				FContext_TagIndex::MatchesContainers(Snapshot.Tags, SnapshotEntries[Index]->RequiredTags, SnapshotEntries[Index]->BlockingTags) :
+				FContext_TagIndex::Matches(Snapshot.Masks, EntryTags);
+		}
+	}, Snapshots.Num() < ParallelEvaluationMinHolders);
+
+	////////
+	/// ~MERGE - game thread, in input order so results are deterministic
+	TSet<UContext_ActionEntry*> Defaults;
+	Defaults.Append(DefaultEntries);
+
+	TArray<UContext_ActionEntry*> ValidEntries;
+	for (const FHolderSnapshot& Snapshot : Snapshots) {
+		ValidEntries.Reset();
+		for (int32 Index = Snapshot.FirstEntry; Index < Snapshot.FirstEntry + Snapshot.NumEntries; ++Index) {
+			if (EntryIsValid[Index]) {
+				ValidEntries.Add(SnapshotEntries[Index]);
+			}
+		}
+
+		if (!Snapshot.bFromCache) {
+			StoreValidEntryCache(Snapshot.ContextHolder, Snapshot.TreeVersion, ValidEntries);
+		}
+
+		TSet<UContext_ActionEntry*> ActionEntries;
+		ActionEntries.Reserve(ValidEntries.Num() + Defaults.Num());
+		ActionEntries.Append(ValidEntries);
+		ActionEntries.Append(Defaults);
+		
+		OutPackages.Add(FContextEntryPackage(Snapshot.ContextHolder, MoveTemp(ActionEntries)));
+	}
 }
 
 UContext_ActionEntry* UContext_ActionSubsystem::GetPrimaryContextEntryForObject(const UObject* ContextObject) const {
@@ -187,6 +830,250 @@ UContext_ActionEntry* UContext_ActionSubsystem::GetPrimaryContextEntryForObject(
 	return nullptr;
 }
 
+void UContext_ActionSubsystem::UpdateSpatialHolder(UObject* ContextHolder, const FVector& Location) {
+	HolderSpatialIndex.Update(ContextHolder, Location);
+}
+
+void UContext_ActionSubsystem::UnregisterSpatialHolder(const UObject* ContextHolder) {
+	HolderSpatialIndex.Remove(ContextHolder);
+}
+
+void UContext_ActionSubsystem::FindContextHoldersInRadius(
+	const FVector Center,
+	const float Radius,
+	TArray<FContextEntryPackage>& OutPackages,
+	const bool bIncludeHoldersWithoutEntries) const {
+
+	TArray<UObject*> Holders;
+	HolderSpatialIndex.QuerySphere(Center, Radius, Holders);
+	BuildSpatialQueryPackages(Holders, OutPackages, bIncludeHoldersWithoutEntries);
+}
+
+void UContext_ActionSubsystem::FindContextHoldersInBox(
+	const FVector Center,
+	const FVector Extent,
+	TArray<FContextEntryPackage>& OutPackages,
+	const bool bIncludeHoldersWithoutEntries) const {
+
+	TArray<UObject*> Holders;
+	HolderSpatialIndex.QueryBox(FBox::BuildAABB(Center, Extent), Holders);
+	BuildSpatialQueryPackages(Holders, OutPackages, bIncludeHoldersWithoutEntries);
+}
+
+void UContext_ActionSubsystem::FindContextHoldersInCone(
+	const FVector Origin,
+	const FVector Direction,
+	const float Length,
+	const float HalfAngleDegrees,
+	TArray<FContextEntryPackage>& OutPackages,
+	const bool bIncludeHoldersWithoutEntries) const {
+
+	TArray<UObject*> Holders;
+	HolderSpatialIndex.QueryCone(Origin, Direction, Length, FMath::DegreesToRadians(HalfAngleDegrees), Holders);
+	BuildSpatialQueryPackages(Holders, OutPackages, bIncludeHoldersWithoutEntries);
+}
+
+void UContext_ActionSubsystem::BuildSpatialQueryPackages(
+	const TConstArrayView<UObject*> ContextHolders,
+	TArray<FContextEntryPackage>& OutPackages,
+	const bool bIncludeHoldersWithoutEntries) const {
+
+	// Wide queries are exactly what parallel evaluation is for. Small ones just run on this thread
+	EvaluateContextPackagesParallel(ContextHolders, {}, OutPackages);
+
+	if (!bIncludeHoldersWithoutEntries) {
+		OutPackages.RemoveAll([](const FContextEntryPackage& Package) {
+			return Package.ContextEntries.IsEmpty();
+		});
+	}
+}
+
+void UContext_ActionSubsystem::NotifyGiverChanged() {
+	// 0 is never a valid epoch, so a default constructed cache entry can't match
+	if (++GiverEpoch == 0) {
+		GiverEpoch = 1;
+	}
+
+	// We don't know which giver changed, and this also drops givers that have since been destroyed
+	GiverEntriesCache.Reset();
+}
+
+void UContext_ActionSubsystem::NotifyContextTreeChanged() {
+	if (++TreeEpoch == 0) {
+		TreeEpoch = 1;
+	}
+	
+	GiverChainCache.Reset();
+}
+
+void UContext_ActionSubsystem::NotifyEntryTagsChanged(const UContext_ActionEntry* Entry) {
+	TagIndex.RemoveEntry(Entry);
+
+	// Cached valid entries and precomputed menus were filtered with the old tags. Giver entries are still right
+	if (++GiverEpoch == 0) {
+		GiverEpoch = 1;
+	}
+}
+
+void UContext_ActionSubsystem::InvalidateContextCache(const UObject* ContextHolder) {
+	ValidEntryCache.Remove(ContextHolder);
+	GiverChainCache.Remove(ContextHolder);
+	GiverEntriesCache.Remove(ContextHolder);
+	PayloadCache.Remove(ContextHolder);
+
+	if (PrecomputedMenu.ContextHolder.Get() == ContextHolder) {
+		ClearPrecomputedContextMenu();
+	}
+}
+
+void UContext_ActionSubsystem::GetContextTreeVersion(
+	const UObject* ContextHolder,
+	FContext_TreeVersion& OutVersion) const {
+
+	OutVersion.Reset();
+	
+	const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+	const uint32 HolderVersion = Holder ? Holder->GetContextVersion() : 0;
+	if (HolderVersion == 0) {
+		return;
+	}
+
+	FContext_GiverLinkArray Givers;
+	GetGiverChain(ContextHolder, DefaultTreeDepth, Givers);
+	for (const FContext_GiverLink& Link : Givers) {
+		const uint32 GiverVersion = GetGiverVersion(Link.Giver.Get());
+		if (GiverVersion == 0) {
+			OutVersion.Reset();
+			return;
+		}
+		
+		OutVersion.GiverVersions.Add(GiverVersion);
+	}
+
+	OutVersion.HolderVersion = HolderVersion;
+}
+
+void UContext_ActionSubsystem::ClearContextCache() {
+	ValidEntryCache.Empty();
+	GiverChainCache.Empty();
+	GiverEntriesCache.Empty();
+	PayloadCache.Empty();
+	TagIndex.Reset();
+	ValidationMemo.Reset();
+	ClearPrecomputedContextMenu();
+}
+
+void UContext_ActionSubsystem::PrecomputeContextMenu(
+	UObject* ContextObject,
+	const TConstArrayView<UContext_ActionEntry*> DefaultEntries) {
+
+	UObject* ContextHolder = IsValid(ContextObject) ? RetrieveValidContextHolderFromObjectNonConst(ContextObject) : nullptr;
+	if (!IsValid(ContextHolder)) return;
+
+	// Already done, and still valid
+	if (IsPrecomputedMenuValid(ContextHolder) && PrecomputedMenu.HasDefaultEntries(DefaultEntries)) return;
+
+	PrecomputedMenu.ContextHolder = ContextHolder;
+	PrecomputedMenu.DefaultEntries.Reset();
+	PrecomputedMenu.DefaultEntries.Append(DefaultEntries.GetData(), DefaultEntries.Num());
+	GetContextTreeVersion(ContextHolder, PrecomputedMenu.TreeVersion);
+	PrecomputedMenu.GiverEpoch = GiverEpoch;
+	PrecomputedMenu.TreeEpoch = TreeEpoch;
+	PrecomputedMenu.Frame = GFrameCounter;
+
+	UObject* ContextHolders[] = { ContextHolder };
+	GetContextEntryPackagesForObjects(ContextHolders, DefaultEntries, PrecomputedMenu.Packages);
+	PrecomputedMenu.PrimaryEntry = GetPrimaryContextEntryForObject(ContextHolder);
+
+	// Start streaming what the menu will need. Payloads are left to the click, their getters may have side effects
+	StreamEntryAssetsForPackages(PrecomputedMenu.Packages);
+}
+
+bool UContext_ActionSubsystem::FindPrecomputedContextMenu(
+	const UObject* ContextObject,
+	const TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+	TArray<FContextEntryPackage>& OutPackages) const {
+
+	const UObject* ContextHolder = IsValid(ContextObject) ? RetrieveValidContextHolderFromObject(ContextObject) : nullptr;
+	if (!IsPrecomputedMenuValid(ContextHolder) || !PrecomputedMenu.HasDefaultEntries(DefaultEntries)) {
+		return false;
+	}
+
+	OutPackages = PrecomputedMenu.Packages;
+	return true;
+}
+
+bool UContext_ActionSubsystem::FindPrecomputedPrimaryEntry(
+	const UObject* ContextObject,
+	UContext_ActionEntry*& OutPrimaryEntry) const {
+
+	const UObject* ContextHolder = IsValid(ContextObject) ? RetrieveValidContextHolderFromObject(ContextObject) : nullptr;
+	if (!IsPrecomputedMenuValid(ContextHolder)) {
+		return false;
+	}
+
+	OutPrimaryEntry = PrecomputedMenu.PrimaryEntry;
+	return true;
+}
+
+void UContext_ActionSubsystem::ClearPrecomputedContextMenu() {
+	PrecomputedMenu = FContext_PrecomputedMenu();
+}
+
+bool UContext_ActionSubsystem::IsPrecomputedMenuValid(const UObject* ContextHolder) const {
+	if (!ContextHolder || PrecomputedMenu.ContextHolder.Get() != ContextHolder) {
+		return false;
+	}
+
+	if (PrecomputedMenu.GiverEpoch != GiverEpoch || PrecomputedMenu.TreeEpoch != TreeEpoch) {
+		return false;
+	}
+
+	// Unversioned holders can't tell us they've changed, so the menu only holds for the frame it was computed in
+	FContext_TreeVersion TreeVersion;
+	GetContextTreeVersion(ContextHolder, TreeVersion);
+	if (!TreeVersion.IsVersioned()) {
+		return PrecomputedMenu.Frame == GFrameCounter;
+	}
+	
+	return TreeVersion == PrecomputedMenu.TreeVersion;
+}
+
+void UContext_ActionSubsystem::GetValidationMemoStats(int64& OutHits, int64& OutMisses) const {
+	OutHits = ValidationMemo.GetHits();
+	OutMisses = ValidationMemo.GetMisses();
+}
+
+void UContext_ActionSubsystem::ResetValidationMemoStats() {
+	ValidationMemo.ResetStats();
+}
+
+void UContext_ActionSubsystem::InvalidatePayloadCache(
+	const UObject* ContextHolder,
+	const UContext_ActionEntry* Entry) {
+
+	if (!IsValid(Entry)) {
+		PayloadCache.Remove(ContextHolder);
+		return;
+	}
+
+	if (FContext_HolderPayloads* HolderPayloads = PayloadCache.Find(ContextHolder)) {
+		HolderPayloads->Remove(Entry);
+	}
+}
+
+void UContext_ActionSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector) {
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// Payloads are usually created on request, so nothing else keeps them alive while they're cached
+	UContext_ActionSubsystem* This = CastChecked<UContext_ActionSubsystem>(InThis);
+	for (TPair<TObjectKey<UObject>, FContext_HolderPayloads>& HolderPayloads : This->PayloadCache) {
+		for (TPair<TObjectKey<UContext_ActionEntry>, FContext_CachedPayload>& Cached : HolderPayloads.Value) {
+			Collector.AddReferencedObject(Cached.Value.Payload, This);
+		}
+	}
+}
+
 UContext_ActionPayloadBase* UContext_ActionSubsystem::FindContextPayloadInTree(
 	const UObject* ContextEntity,
 	const TSubclassOf<UContext_ActionPayloadBase> PayloadClass,
@@ -199,19 +1086,16 @@ UContext_ActionPayloadBase* UContext_ActionSubsystem::FindContextPayloadInTree(
 		return nullptr;;
 	}
 
-	int CurrentDepth = 1;
-	UObject* CurrentRoot = GetNextObjectInTree(ContextEntity);
-	while(IsValid(CurrentRoot) && CurrentDepth <= MaxDepth) {
-
-		if (CurrentRoot->Implements<UContext_Giver>()) {
-			UContext_ActionPayloadBase* FoundPayload = IContext_Giver::Execute_RequestContextPayload(CurrentRoot, PayloadClass);
-			if (IsValid(FoundPayload)) {
-				return FoundPayload;
-			}
+	FContext_GiverLinkArray Givers;
+	GetGiverChain(ContextEntity, MaxDepth, Givers);
+	for (const FContext_GiverLink& Link : Givers) {
+		UObject* Giver = Link.Giver.Get();
+		if (!IsValid(Giver)) continue;
+		
+		UContext_ActionPayloadBase* FoundPayload = IContext_Giver::Execute_RequestContextPayload(Giver, PayloadClass);
+		if (IsValid(FoundPayload)) {
+			return FoundPayload;
 		}
-
-		CurrentRoot = GetNextObjectInTree(CurrentRoot);
-		CurrentDepth++;
 	}
 
 	return nullptr;
@@ -222,6 +1106,8 @@ TSet<UContext_ActionEntry*> UContext_ActionSubsystem::AggregateContextEntriesInT
 	const UObject* ContextEntity,
 	const int MaxDepth) const {
 
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_TreeAggregation);
+	
 	TSet<UContext_ActionEntry*> Entries;
 	
 	if (!ContextEntity->Implements<UContext_Holder>()) {
@@ -230,16 +1116,14 @@ TSet<UContext_ActionEntry*> UContext_ActionSubsystem::AggregateContextEntriesInT
 											*GetFullName());
 		return Entries;;
 	}
-	
-	int CurrentDepth = 1;
-	UObject* CurrentRoot = GetNextObjectInTree(ContextEntity);
-	while(IsValid(CurrentRoot) && CurrentDepth <= MaxDepth) {
-		if (CurrentRoot->Implements<UContext_Giver>()) {
-			IContext_Giver::Execute_GetGiverContextEntries(CurrentRoot, Entries);
-		}
 
-		CurrentRoot = GetNextObjectInTree(CurrentRoot);
-		CurrentDepth++;
+	FContext_GiverLinkArray Givers;
+	GetGiverChain(ContextEntity, MaxDepth, Givers);
+	for (const FContext_GiverLink& Link : Givers) {
+		UObject* Giver = Link.Giver.Get();
+		if (!IsValid(Giver)) continue;
+		
+		Entries.Append(GetGiverEntries(Giver));
 	}
 
 	return Entries;
@@ -254,22 +1138,131 @@ UContext_ActionEntry* UContext_ActionSubsystem::FindPrimaryContextEntryInTree(
 											*GetFullName());
 		return nullptr;;
 	}
+
+	FContext_GiverLinkArray Givers;
+	GetGiverChain(ContextEntity, MaxDepth, Givers);
+	for (const FContext_GiverLink& Link : Givers) {
+		UObject* Giver = Link.Giver.Get();
+		if (!IsValid(Giver)) continue;
+
+		UContext_ActionEntry* ActionEntry = GetGiverPrimaryEntry(Giver);
+		if (IsValid(ActionEntry)) {
+			return ActionEntry;
+		}
+	}
+
+	return nullptr;
+}
+
+void UContext_ActionSubsystem::GetGiverChain(
+	const UObject* ContextHolder,
+	const int32 MaxDepth,
+	FContext_GiverLinkArray& OutGivers) const {
+
+	OutGivers.Reset();
+	
+	// Unversioned holders have no way to tell us they've been destroyed, so don't keep anything around for them
+	const IContext_Holder* Holder = Cast<IContext_Holder>(ContextHolder);
+	if (!Holder || Holder->GetContextVersion() == 0) {
+		FContext_GiverChain Chain;
+		BuildGiverChain(ContextHolder, MaxDepth, Chain);
+		OutGivers.Append(Chain.Givers);
+		return;
+	}
+
+	FContext_GiverChain& Chain = GiverChainCache.FindOrAdd(ContextHolder);
+	if (Chain.TreeEpoch != TreeEpoch || !Chain.CoversDepth(MaxDepth)) {
+		BuildGiverChain(ContextHolder, MaxDepth, Chain);
+	}
+	
+	for (const FContext_GiverLink& Link : Chain.Givers) {
+		if (Link.Depth > MaxDepth) break;
+		OutGivers.Add(Link);
+	}
+}
+
+void UContext_ActionSubsystem::BuildGiverChain(
+	const UObject* ContextHolder,
+	const int32 MaxDepth,
+	FContext_GiverChain& OutChain) const {
+
+	OutChain.Givers.Reset();
+	OutChain.TreeEpoch = TreeEpoch;
+	OutChain.BuiltDepth = MaxDepth;
 	
-	int CurrentDepth = 1;
-	UObject* CurrentRoot = GetNextObjectInTree(ContextEntity);
+	int32 CurrentDepth = 1;
+	UObject* CurrentRoot = GetNextObjectInTree(ContextHolder);
 	while(IsValid(CurrentRoot) && CurrentDepth <= MaxDepth) {
 		if (CurrentRoot->Implements<UContext_Giver>()) {
-			UContext_ActionEntry* ActionEntry = IContext_Giver::Execute_GetPrimaryContextEntry(CurrentRoot);
-			if (IsValid(ActionEntry)) {
-				return ActionEntry;
-			}
+			OutChain.Givers.Add({CurrentRoot, CurrentDepth});
 		}
 
 		CurrentRoot = GetNextObjectInTree(CurrentRoot);
 		CurrentDepth++;
 	}
 
-	return nullptr;
+	OutChain.bReachedRoot = !IsValid(CurrentRoot);
+}
+
+const TSet<UContext_ActionEntry*>& UContext_ActionSubsystem::GetGiverEntries(UObject* Giver) const {
+	// Unversioned givers can't tell us their entries changed, so they're never cached
+	const uint32 GiverVersion = GetGiverVersion(Giver);
+	if (GiverVersion == 0) {
+		TSet<UContext_ActionEntry*> Entries;
+		IContext_Giver::Execute_GetGiverContextEntries(Giver, Entries);
+		UnversionedGiverEntries = MoveTemp(Entries);
+		return UnversionedGiverEntries;
+	}
+	
+	if (const FContext_GiverEntries* Cached = GiverEntriesCache.Find(Giver);
+		Cached && Cached->bEntriesResolved && Cached->GiverVersion == GiverVersion) {
+		return Cached->Entries;
+	}
+
+	// Giver is a BlueprintNativeEvent that may call back into us, so don't hold on to map memory while it runs
+	TSet<UContext_ActionEntry*> Entries;
+	IContext_Giver::Execute_GetGiverContextEntries(Giver, Entries);
+	
+	FContext_GiverEntries& GiverEntries = FindOrAddGiverEntries(Giver, GiverVersion);
+	GiverEntries.Entries = MoveTemp(Entries);
+	GiverEntries.bEntriesResolved = true;
+	return GiverEntries.Entries;
+}
+
+UContext_ActionEntry* UContext_ActionSubsystem::GetGiverPrimaryEntry(UObject* Giver) const {
+	const uint32 GiverVersion = GetGiverVersion(Giver);
+	if (GiverVersion == 0) {
+		return IContext_Giver::Execute_GetPrimaryContextEntry(Giver);
+	}
+	
+	if (const FContext_GiverEntries* Cached = GiverEntriesCache.Find(Giver);
+		Cached && Cached->bPrimaryResolved && Cached->GiverVersion == GiverVersion) {
+		return Cached->PrimaryEntry;
+	}
+
+	UContext_ActionEntry* PrimaryEntry = IContext_Giver::Execute_GetPrimaryContextEntry(Giver);
+	
+	FContext_GiverEntries& GiverEntries = FindOrAddGiverEntries(Giver, GiverVersion);
+	GiverEntries.PrimaryEntry = PrimaryEntry;
+	GiverEntries.bPrimaryResolved = true;
+	return PrimaryEntry;
+}
+
+FContext_GiverEntries& UContext_ActionSubsystem::FindOrAddGiverEntries(const UObject* Giver, const uint32 GiverVersion) const {
+	FContext_GiverEntries& GiverEntries = GiverEntriesCache.FindOrAdd(Giver);
+	
+	// Whatever was resolved against an older version is stale
+	if (GiverEntries.GiverVersion != GiverVersion) {
+		GiverEntries = FContext_GiverEntries();
+		GiverEntries.GiverVersion = GiverVersion;
+	}
+	return GiverEntries;
+}
+
+uint32 UContext_ActionSubsystem::GetGiverVersion(const UObject* Giver) {
+	// Blueprint implemented givers have no native interface, and are unversioned
+	const IContext_Giver* GiverInterface = Cast<IContext_Giver>(Giver);
+	return GiverInterface ? GiverInterface->GetContextVersion() : 0;
 }
 
 UObject* UContext_ActionSubsystem::GetNextObjectInTree(const UObject* ContextEntity) const {
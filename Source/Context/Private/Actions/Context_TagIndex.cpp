@@ -0,0 +1,87 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Actions/Context_TagIndex.h"
+
+#include "Actions/Context_ActionEntry.h"
+
+const FContext_CompiledEntryTags& FContext_TagIndex::CompileEntry(const UContext_ActionEntry* Entry) {
+	if (const FContext_CompiledEntryTags* Compiled = CompiledEntries.Find(Entry)) {
+		return *Compiled;
+	}
+
+	AddReferencedTags(Entry->RequiredTags);
+	AddReferencedTags(Entry->BlockingTags);
+	
+	FContext_CompiledEntryTags Compiled;
+	const bool bRequiredFits = AddTagsToMask(Entry->RequiredTags, Compiled.Required);
+	const bool bBlockingFits = AddTagsToMask(Entry->BlockingTags, Compiled.Blocking);
+	Compiled.bRequiresFallback = !bRequiredFits || !bBlockingFits;
+
+	return CompiledEntries.Add(Entry, Compiled);
+}
+
+void FContext_TagIndex::RemoveEntry(const UContext_ActionEntry* Entry) {
+	CompiledEntries.Remove(Entry);
+}
+
+void FContext_TagIndex::BuildHolderMasks(const FGameplayTagContainer& OwnedTags, FContext_HolderTagMasks& OutMasks) const {
+	OutMasks.Exact.Reset();
+	OutMasks.Expanded.Reset();
+
+	for (const FGameplayTag& OwnedTag : OwnedTags) {
+		if (const int32* Index = TagToIndex.Find(OwnedTag)) {
+			OutMasks.Exact.SetBit(*Index);
+		}
+
+		// Walk up the hierarchy, an owned Tag.A.B is blocked by Tag.A
+		for (FGameplayTag Tag = OwnedTag; Tag.IsValid(); Tag = Tag.RequestDirectParent()) {
+			if (const int32* Index = TagToIndex.Find(Tag)) {
+				OutMasks.Expanded.SetBit(*Index);
+			}
+		}
+	}
+}
+
+bool FContext_TagIndex::IsReferenced(const FGameplayTag& Tag) const {
+	// Blocking tags match their children, so a change to Tag.A.B matters if Tag.A is referenced
+	for (FGameplayTag Current = Tag; Current.IsValid(); Current = Current.RequestDirectParent()) {
+		if (ReferencedTags.Contains(Current)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void FContext_TagIndex::Reset() {
+	TagToIndex.Reset();
+	CompiledEntries.Reset();
+	ReferencedTags.Reset();
+	++ReferencedTagsVersion;
+}
+
+void FContext_TagIndex::AddReferencedTags(const FGameplayTagContainer& Tags) {
+	for (const FGameplayTag& Tag : Tags) {
+		bool bAlreadyReferenced = false;
+		ReferencedTags.Add(Tag, &bAlreadyReferenced);
+		if (!bAlreadyReferenced) {
+			++ReferencedTagsVersion;
+		}
+	}
+}
+
+bool FContext_TagIndex::AddTagsToMask(const FGameplayTagContainer& Tags, FContext_TagMask& OutMask) {
+	for (const FGameplayTag& Tag : Tags) {
+		int32 Index = INDEX_NONE;
+		if (const int32* ExistingIndex = TagToIndex.Find(Tag)) {
+			Index = *ExistingIndex;
+		} else if (TagToIndex.Num() < FContext_TagMask::NumBits) {
+			Index = TagToIndex.Add(Tag, TagToIndex.Num());
+		} else {
+			return false;
+		}
+		
+		OutMask.SetBit(Index);
+	}
+	return true;
+}
@@ -6,8 +6,11 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemInterface.h"
 #include "Context_ActionPayloadBase.h"
+#include "Context_Stats.h"
 #include "Actions/Context_Action.h"
 #include "Actions/Context_ActionEntry.h"
+#include "Actions/Context_ActionSubsystem.h"
+#include "Interface/Context_PayloadFunctionTable.h"
 #include "Misc/DataValidation.h"
 
 // Sets default values for this component's properties
@@ -18,20 +21,49 @@ UContext_HolderComponent::UContext_HolderComponent() {
 }
 
 void UContext_HolderComponent::GetOwnedGameplayTags(FGameplayTagContainer& TagContainer) const {
-
-	FGameplayTagContainer OwnedTags;
+	TagContainer.Reset();
 	
+	// Live tags, the mirror may be missing tags no entry references
 	const IAbilitySystemInterface* ASI = Cast<IAbilitySystemInterface>(GetOwner());
-	if (ASI)
-	{
-		ASI->GetAbilitySystemComponent()->GetOwnedGameplayTags(OwnedTags);
+	if (const UAbilitySystemComponent* ASC = ASI ? ASI->GetAbilitySystemComponent() : nullptr) {
+		ASC->GetOwnedGameplayTags(TagContainer);
 	}
 
-	if (OwnedTags.IsEmpty()) {
-		OwnedTags.AppendTags(DefaultTags);
+	if (TagContainer.IsEmpty()) {
+		TagContainer.AppendTags(DefaultTags);
 	}
+}
+
+const FGameplayTagContainer& UContext_HolderComponent::GetContextTagsMirror() const {
+	const UContext_ActionSubsystem* Subsystem = CachedActionSubsystem.Get();
+	const uint32 ReferencedTagsVersion = Subsystem ? Subsystem->GetReferencedTagsVersion() : 0;
 	
-	TagContainer = OwnedTags;
+	// Changes to tags that weren't referenced yet were ignored, so refresh when new tags become referenced
+	if (!bOwnedTagsMirrorValid || ReferencedTagsVersion != MirrorReferencedTagsVersion) {
+		RefreshOwnedTagsMirror();
+		MirrorReferencedTagsVersion = ReferencedTagsVersion;
+		
+		// Without tag events, we can't know when the mirror is stale and have to refresh every time
+		bOwnedTagsMirrorValid = Subsystem && (BoundAbilitySystem.IsValid() || bUsesDefaultTagsOnly);
+	}
+
+	return OwnedTagsMirror;
+}
+
+void UContext_HolderComponent::RefreshOwnedTagsMirror() const {
+	OwnedTagsMirror.Reset();
+	
+	const IAbilitySystemInterface* ASI = Cast<IAbilitySystemInterface>(GetOwner());
+	if (ASI) {
+		if (const UAbilitySystemComponent* ASC = ASI->GetAbilitySystemComponent()) {
+			ASC->GetOwnedGameplayTags(OwnedTagsMirror);
+		}
+	}
+
+	bMirrorUsesDefaultTags = OwnedTagsMirror.IsEmpty();
+	if (bMirrorUsesDefaultTags) {
+		OwnedTagsMirror.AppendTags(DefaultTags);
+	}
 }
 
 FVector UContext_HolderComponent::GetPosition_Implementation() const {
@@ -42,6 +74,13 @@ TSet<UContext_ActionEntry*> UContext_HolderComponent::GetActionEntries_Implement
 	return ContextEntries;
 }
 
+const TSet<UContext_ActionEntry*>* UContext_HolderComponent::GetActionEntriesView() const {
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IContext_Holder, GetActionEntries))) {
+		return nullptr;
+	}
+	return &ContextEntries;
+}
+
 FText UContext_HolderComponent::GetDisplayName_Implementation() const {
 	if (bDisplayNameOverride) {
 		return DisplayNameOverride;
@@ -57,13 +96,8 @@ FText UContext_HolderComponent::GetDisplayName_Implementation() const {
 const UContext_ActionPayloadBase* UContext_HolderComponent::RequestPayloadOfType_Implementation(
 	TSubclassOf<UContext_ActionPayloadBase> PayloadType) const {
 
-	TSet<UContext_ActionEntry*> Entries = ContextEntries.Union(TSet(PrimaryContextEntryPriority));
-	for (const auto Entry : Entries) {
-		if (Entry->Action->GetDefaultObject<UContext_Action>()->PayloadClass == PayloadType) {
-			return Execute_RequestPayload(this, Entry);
-		}
-	}
-	return nullptr;
+	const UContext_ActionEntry* Entry = PayloadClassIndex.Find(PayloadType, ContextEntries, PrimaryContextEntryPriority);
+	return Entry ? Execute_RequestPayload(this, Entry) : nullptr;
 }
 
 TArray<UContext_ActionEntry*> UContext_HolderComponent::GetPrimaryActionEntries_Implementation() const {
@@ -74,7 +108,7 @@ const UContext_ActionPayloadBase* UContext_HolderComponent::RequestPayload_Imple
 	const UContext_ActionEntry* ActionEntry) const {
 	
 	FName ExpectedFunctionName;
-	UFunction* PayloadFunc = GetFunctionForAction(ActionEntry->ActionName.ToString(), ExpectedFunctionName);
+	UFunction* PayloadFunc = GetFunctionForAction(ActionEntry, ExpectedFunctionName);
 	
 	// Function should be valid, if not then it hasn't been defined
 	if (!IsValid(PayloadFunc)) {
@@ -90,20 +124,187 @@ const UContext_ActionPayloadBase* UContext_HolderComponent::RequestPayload_Imple
 		UContext_ActionPayloadBase* ReturnValue;
 	};
 	
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_PayloadRequest);
+	INC_DWORD_STAT(STAT_Context_NumPayloadRequests);
+	TRACE_COUNTER_INCREMENT(Context_PayloadRequests);
+	
 	FPayloadFuncParams Params;
 	GetOwner()->ProcessEvent(PayloadFunc, &Params);
 	
 	return Params.ReturnValue;
 }
 
+const UFunction* UContext_HolderComponent::GetPayloadFunction(const UContext_ActionEntry* ActionEntry) const {
+	// A Blueprint RequestPayload may not call the payload function at all
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IContext_Holder, RequestPayload))) {
+		return nullptr;
+	}
+
+	FName ExpectedFunctionName;
+	return GetFunctionForAction(ActionEntry, ExpectedFunctionName);
+}
+
 void UContext_HolderComponent::SetDisplayName(FText Name) {
 	DisplayName = Name;
 }
 
+void UContext_HolderComponent::SetContextEntries(const TSet<UContext_ActionEntry*>& Entries) {
+	ContextEntries = Entries;
+	PayloadClassIndex.MarkDirty();
+	MarkContextDirty();
+}
+
+void UContext_HolderComponent::SetPrimaryContextEntryPriority(const TArray<UContext_ActionEntry*>& Entries) {
+	PrimaryContextEntryPriority = Entries;
+	PayloadClassIndex.MarkDirty();
+	MarkContextDirty();
+}
+
+uint32 UContext_HolderComponent::GetContextVersion() const {
+	// Checked here rather than relying on BeginPlay, holders may be queried before it
+	if (bUsesDefaultTagsOnly || !Cast<IAbilitySystemInterface>(GetOwner())) {
+		return ContextVersion;
+	}
+
+	// Binding only touches our own listener state, the holder is logically unchanged
+	return const_cast<UContext_HolderComponent*>(this)->TryBindAbilitySystem() ? ContextVersion : 0;
+}
+
+bool UContext_HolderComponent::TryBindAbilitySystem() {
+	const IAbilitySystemInterface* ASI = Cast<IAbilitySystemInterface>(GetOwner());
+	UAbilitySystemComponent* ASC = ASI ? ASI->GetAbilitySystemComponent() : nullptr;
+	if (ASC && BoundAbilitySystem.Get() == ASC) {
+		return true;
+	}
+
+	// Lost or swapped ability system, whatever we mirrored from the old one is stale
+	if (BoundAbilitySystem.IsValid() || OwnedTagChangedHandle.IsValid()) {
+		UnbindAbilitySystem();
+		MarkContextDirty();
+	}
+
+	// Don't bind before BeginPlay or after EndPlay, nothing would unbind us
+	if (!IsValid(ASC) || !HasBegunPlay()) {
+		return false;
+	}
+
+	// Any tag change on the ASC can change which entries are valid
+	OwnedTagChangedHandle = ASC->RegisterGenericGameplayTagEvent().AddUObject(this, &UContext_HolderComponent::OnOwnedTagChanged);
+	BoundAbilitySystem = ASC;
+	MarkContextDirty();
+	
+	return true;
+}
+
+void UContext_HolderComponent::UnbindAbilitySystem() {
+	if (UAbilitySystemComponent* ASC = BoundAbilitySystem.Get()) {
+		ASC->RegisterGenericGameplayTagEvent().Remove(OwnedTagChangedHandle);
+	}
+	BoundAbilitySystem.Reset();
+	OwnedTagChangedHandle.Reset();
+	bOwnedTagsMirrorValid = false;
+}
+
+void UContext_HolderComponent::MarkContextDirty() {
+	bOwnedTagsMirrorValid = false;
+	
+	// 0 is reserved for unversioned holders
+	if (++ContextVersion == 0) {
+		ContextVersion = 1;
+	}
+}
+
 // Called when the game starts
 void UContext_HolderComponent::BeginPlay() {
 	Super::BeginPlay();
+
+	CachedActionSubsystem = GetActionSubsystem();
+	bOwnedTagsMirrorValid = false;
+
+	// No ASC to bind yet is fine, we retry when queried
+	bUsesDefaultTagsOnly = Cast<IAbilitySystemInterface>(GetOwner()) == nullptr;
+	if (!bUsesDefaultTagsOnly) {
+		TryBindAbilitySystem();
+	}
+
+	// Resolve payload functions now rather than on the first execution
+	FContext_PayloadFunctionTable::WarmClass(GetOwner()->GetClass(), ContextEntries, PrimaryContextEntryPriority);
+
+	// Follow the owner around so spatial queries can find us
+	if (bRegisterInSpatialIndex) {
+		if (UContext_ActionSubsystem* Subsystem = GetActionSubsystem()) {
+			Subsystem->UpdateSpatialHolder(this, GetOwner()->GetActorLocation());
+		}
+
+		if (USceneComponent* RootComponent = GetOwner()->GetRootComponent()) {
+			TransformUpdatedHandle = RootComponent->TransformUpdated.AddUObject(this, &UContext_HolderComponent::OnOwnerTransformUpdated);
+			BoundRootComponent = RootComponent;
+		}
+	}
+}
+
+void UContext_HolderComponent::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	UnbindAbilitySystem();
+
+	if (USceneComponent* RootComponent = BoundRootComponent.Get()) {
+		RootComponent->TransformUpdated.Remove(TransformUpdatedHandle);
+	}
+	BoundRootComponent.Reset();
+	TransformUpdatedHandle.Reset();
+	
+	if (UContext_ActionSubsystem* Subsystem = GetActionSubsystem()) {
+		Subsystem->UnregisterSpatialHolder(this);
+	}
+
+	InvalidateCachedContext();
+	
+	Super::EndPlay(EndPlayReason);
+}
+
+void UContext_HolderComponent::OnRegister() {
+	Super::OnRegister();
+	InvalidateCachedContext();
+}
+
+void UContext_HolderComponent::PostRename(UObject* OldOuter, const FName OldName) {
+	Super::PostRename(OldOuter, OldName);
+	InvalidateCachedContext();
+}
+
+void UContext_HolderComponent::OnOwnedTagChanged(const FGameplayTag Tag, int32 NewCount) {
+	// Buffs ticking tags no entry cares about shouldn't invalidate anything
+	const UContext_ActionSubsystem* Subsystem = CachedActionSubsystem.Get();
+	if (Subsystem && !Subsystem->IsGameplayTagReferenced(Tag)) {
+		// Unless they decide whether DefaultTags apply: those only do while the ability system has no tags at all
+		const bool bMayToggleDefaultTags = !DefaultTags.IsEmpty() && (NewCount > 0) == bMirrorUsesDefaultTags;
+		if (!bMayToggleDefaultTags) {
+			return;
+		}
+	}
 	
+	MarkContextDirty();
+}
+
+void UContext_HolderComponent::OnOwnerTransformUpdated(
+	USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags,
+	ETeleportType Teleport) {
+
+	if (UContext_ActionSubsystem* Subsystem = GetActionSubsystem()) {
+		Subsystem->UpdateSpatialHolder(this, UpdatedComponent->GetComponentLocation());
+	}
+}
+
+void UContext_HolderComponent::InvalidateCachedContext() const {
+	if (UContext_ActionSubsystem* Subsystem = GetActionSubsystem()) {
+		Subsystem->InvalidateContextCache(this);
+	}
+}
+
+UContext_ActionSubsystem* UContext_HolderComponent::GetActionSubsystem() const {
+	const UWorld* World = GetWorld();
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UContext_ActionSubsystem>() : nullptr;
 }
 
 #if WITH_EDITOR
@@ -121,12 +322,14 @@ EDataValidationResult UContext_HolderComponent::IsDataValid(FDataValidationConte
 	//// Validate all context entries
 	TSet<UContext_ActionEntry*> EntriesToValidate = ContextEntries.Union(TSet(PrimaryContextEntryPriority));
 	for (const auto Entry : EntriesToValidate) {
-		const UContext_Action* BaseAction = Entry->Action.GetDefaultObject();
-
+		const UClass* ActionClass = Entry->LoadActionClass();
+		if (!ActionClass) continue;
+		
+		const UContext_Action* BaseAction = ActionClass->GetDefaultObject<UContext_Action>();
 		if (!IsValid(BaseAction->PayloadClass)) continue;
 		
 		FName ExpectedFunctionName;
-		const UFunction* Function = GetFunctionForAction(Entry->ActionName.ToString(), ExpectedFunctionName);
+		const UFunction* Function = GetFunctionForAction(Entry, ExpectedFunctionName);
 		
 		// PAYLOAD FUNCTION SHOULD EXIST FOR CONTEXT ENTRY
 		if (!IsValid(Function)) {
@@ -170,28 +373,15 @@ EDataValidationResult UContext_HolderComponent::IsDataValid(FDataValidationConte
 }
 #endif
 
-UFunction* UContext_HolderComponent::GetFunctionForAction(const FString& ActionName, FName& ExpectedFunctionName) const {
+UFunction* UContext_HolderComponent::GetFunctionForAction(const UContext_ActionEntry* ActionEntry, FName& ExpectedFunctionName) const {
 
 	const AActor* OwningActor = GetOwner();
-	if (!IsValid(OwningActor)) {
+	if (!IsValid(OwningActor) || !IsValid(ActionEntry)) {
 		return nullptr;
 	}
-	
-	// ~name stuff
-	// really funky, but it basically just copies how blueprint strings are named by default
-	const FString FunctionNameBase = FString::Printf(TEXT("%s_%s"), *ContextPayloadFunctionPrefix, *ActionName);
-	const FName DisplayFunctionName = FName(
-		FName::NameToDisplayString(
-			FunctionNameBase,
-			false));
-	ExpectedFunctionName = FName(FunctionNameBase);
-	// ~name stuff end
 
-		
-	UFunction* FunctionForAction = OwningActor->FindFunction(DisplayFunctionName);
-	if (!IsValid(FunctionForAction)) {
-		return OwningActor->FindFunction(ExpectedFunctionName);
-	}
+	FName DisplayFunctionName;
+	ActionEntry->GetPayloadFunctionNames(DisplayFunctionName, ExpectedFunctionName);
 
-	return FunctionForAction;
+	return FContext_PayloadFunctionTable::FindPayloadFunction(OwningActor->GetClass(), ActionEntry);
 }
@@ -0,0 +1,30 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Context_Stats.h"
+
+UE_TRACE_CHANNEL_DEFINE(ContextChannel);
+
+DEFINE_STAT(STAT_Context_OpenMenuTrace);
+DEFINE_STAT(STAT_Context_GetValidEntries);
+DEFINE_STAT(STAT_Context_TreeAggregation);
+DEFINE_STAT(STAT_Context_CanExecuteEntry);
+DEFINE_STAT(STAT_Context_RunValidations);
+DEFINE_STAT(STAT_Context_PayloadRequest);
+DEFINE_STAT(STAT_Context_CreateAction);
+DEFINE_STAT(STAT_Context_ShowMenu);
+
+DEFINE_STAT(STAT_Context_NumEntryQueries);
+DEFINE_STAT(STAT_Context_NumEntryChecks);
+DEFINE_STAT(STAT_Context_NumValidationRuns);
+DEFINE_STAT(STAT_Context_NumPayloadRequests);
+DEFINE_STAT(STAT_Context_NumActionsCreated);
+DEFINE_STAT(STAT_Context_NumMenusShown);
+
+DEFINE_STAT(STAT_Context_InputToMenuVisibleMs);
+
+TRACE_DECLARE_INT_COUNTER(Context_EntryQueries, TEXT("Context/Entry Queries"));
+TRACE_DECLARE_INT_COUNTER(Context_ValidationRuns, TEXT("Context/Validation Runs"));
+TRACE_DECLARE_INT_COUNTER(Context_PayloadRequests, TEXT("Context/Payload Requests"));
+TRACE_DECLARE_INT_COUNTER(Context_ActionsCreated, TEXT("Context/Actions Created"));
+TRACE_DECLARE_FLOAT_COUNTER(Context_InputToMenuVisibleMs, TEXT("Context/Input To Menu Visible (ms)"));
@@ -3,6 +3,8 @@
 
 #include "Context_SystemComponent.h"
 
+#include "Context_Settings.h"
+#include "Context_Stats.h"
 #include "EnhancedInputComponent.h"
 #include "Actions/Context_ActionSubsystem.h"
 #include "Blueprint/UserWidget.h"
@@ -14,13 +16,18 @@
 
 // Sets default values
 UContext_SystemComponent::UContext_SystemComponent() {
+	// Only ticks while hover tracking is enabled
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	MenuTraceDelegate.BindUObject(this, &UContext_SystemComponent::OnMenuTraceCompleted);
 }
 
 void UContext_SystemComponent::BeginPlay() {
 	Super::BeginPlay();
 	ensure(OpenContextInputAction);
 	ensure(CloseContextInputAction);
-	ensure(ContextMenuTemplate);
+	ensure(ContextMenuTemplate || !GetDefault<UContext_Settings>()->ContextMenuClass.IsNull());
 	
 	AActor* ContextOwner = GetOwner();
 	if (ContextOwner->HasAuthority()) {
@@ -37,77 +44,254 @@ void UContext_SystemComponent::BeginPlay() {
 		EnhancedInputComp->BindAction(OpenContextInputAction, ETriggerEvent::Completed, this, &UContext_SystemComponent::OpenContextMenu);
 		EnhancedInputComp->BindAction(CloseContextInputAction, ETriggerEvent::Completed, ActionSubsystem, &UContext_ActionSubsystem::HideUnfocusedContextMenu);
 
-		// UContext_Menu* ContextMenu = CreateWidget<UContext_Menu>(GetWorld(), ContextMenuTemplate);
-		// ContextMenu->AddToViewport();
-		// ContextMenu->HideMenu();
-
-		//ActionSubsystem->SetContextMenuInstance(ContextMenu);
+		// Our template wins over the settings' prewarmed menu. Without one, the settings' menu is used once it's loaded
+		if (ContextMenuTemplate) {
+			ActionSubsystem->PrewarmContextMenu(ContextMenuTemplate);
+		}
+		ActionSubsystem->SetContextMenuOwner(GetCurrentActorController());
+		
 		ActionSubsystem->EnableContextSource(EContext_ContextSource::World);
 		ActionSubsystem->EnableContextSource(EContext_ContextSource::UI);
+
+		SetHoverTrackingEnabled(bEnableHoverTracking);
+	}
+}
+
+void UContext_SystemComponent::TickComponent(
+	const float DeltaTime,
+	const ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction) {
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateHover();
+	UpdateHoverDwell();
+}
+
+void UContext_SystemComponent::SetHoverTrackingEnabled(const bool bEnabled) {
+	bEnableHoverTracking = bEnabled;
+	
+	// Tick interval is the trace rate
+	SetComponentTickInterval(HoverTraceInterval);
+	SetComponentTickEnabled(bEnabled);
+
+	if (!bEnabled) {
+		bHasHoverTraced = false;
+		SetHoveredContextHolder(nullptr);
 	}
 }
 
+bool UContext_SystemComponent::GetCursorRay(
+	const APlayerController* PlayerController,
+	FVector2D& OutMousePosition,
+	FVector& OutStart,
+	FVector& OutDirection) const {
+
+	ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
+	if (!IsValid(LocalPlayer) || !LocalPlayer->ViewportClient) return false;
+
+	if (!LocalPlayer->ViewportClient->GetMousePosition(OutMousePosition)) return false;
+	
+	// Convert mouse position to 3D raycast start and end points
+	return PlayerController->DeprojectMousePositionToWorld(OutStart, OutDirection);
+}
+
+void UContext_SystemComponent::UpdateHover() {
+	if (!IsValid(ActionSubsystem)) return;
+	
+	const APlayerController* PlayerController = GetCurrentActorController();
+	if (!IsValid(PlayerController) || !ActionSubsystem->CheckSourceEnabled(EContext_ContextSource::World)) {
+		SetHoveredContextHolder(nullptr);
+		return;
+	}
+
+	FVector2D MousePosition;
+	FVector Start, Direction;
+	if (!GetCursorRay(PlayerController, MousePosition, Start, Direction)) {
+		SetHoveredContextHolder(nullptr);
+		return;
+	}
+
+	// Same cursor and same view would hit the same thing. Still check the hovered holder, its tags may have changed
+	FVector CameraLocation;
+	FRotator CameraRotation;
+	PlayerController->GetPlayerViewPoint(CameraLocation, CameraRotation);
+	
+	const bool bViewUnchanged = bHasHoverTraced
+		&& FVector2D::DistSquared(MousePosition, LastHoverMousePosition) <= FMath::Square(HoverCursorDeadZone)
+		&& CameraLocation.Equals(LastHoverCameraLocation)
+		&& CameraRotation.Equals(LastHoverCameraRotation);
+	
+	if (bViewUnchanged) {
+		SetHoveredContextHolder(HoveredContextHolder.Get());
+		return;
+	}
+
+	bHasHoverTraced = true;
+	LastHoverMousePosition = MousePosition;
+	LastHoverCameraLocation = CameraLocation;
+	LastHoverCameraRotation = CameraRotation;
+
+	// Only the first thing under the cursor matters for hovering
+	FHitResult Hit;
+	const FCollisionQueryParams TraceParams = FCollisionQueryParams(FName(TEXT("")), true, PlayerController);
+	const FVector End = Start + Direction * MaxTraceDistance;
+	
+	UObject* ContextHolder = nullptr;
+	if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ContextTraceChannel, TraceParams) && IsValid(Hit.GetActor())) {
+		ContextHolder = ActionSubsystem->RetrieveValidContextHolderFromObjectNonConst(Hit.GetActor());
+	}
+	
+	SetHoveredContextHolder(ContextHolder);
+}
+
+void UContext_SystemComponent::SetHoveredContextHolder(UObject* ContextHolder) {
+	// The primary entry may come from givers above the holder, so their versions matter too
+	FContext_TreeVersion ContextVersion;
+	if (IsValid(ContextHolder) && IsValid(ActionSubsystem)) {
+		ActionSubsystem->GetContextTreeVersion(ContextHolder, ContextVersion);
+	}
+
+	// Unversioned holders can't tell us they've changed, so they're always re-resolved
+	const bool bSameHolder = HoveredContextHolder.Get() == ContextHolder;
+	if (bSameHolder && ContextVersion.IsVersioned() && ContextVersion == HoveredContextVersion) {
+		return;
+	}
+
+	UContext_ActionEntry* PrimaryEntry = IsValid(ContextHolder) && IsValid(ActionSubsystem) ?
+		ActionSubsystem->GetPrimaryContextEntryForObject(ContextHolder) :
+		nullptr;
+
+	const bool bChanged = !bSameHolder || PrimaryEntry != HoveredPrimaryEntry;
+	
+	// The dwell starts over for a new holder, and a changed holder needs its menu computed again
+	if (!bSameHolder) {
+		HoverStartTime = GetWorld()->GetTimeSeconds();
+	}
+	bHoverMenuPrecomputed = false;
+	
+	HoveredContextHolder = ContextHolder;
+	HoveredContextVersion = MoveTemp(ContextVersion);
+	HoveredPrimaryEntry = PrimaryEntry;
+
+	// Whatever is hovered is likely to be executed soon
+	if (PrimaryEntry && IsValid(ActionSubsystem)) {
+		ActionSubsystem->StreamEntryAssets(PrimaryEntry);
+	}
+
+	if (bChanged) {
+		OnHoveredContextChanged.Broadcast(ContextHolder, PrimaryEntry);
+	}
+}
+
+void UContext_SystemComponent::UpdateHoverDwell() {
+	if (bHoverMenuPrecomputed || HoverDwellTime <= 0.f || !IsValid(ActionSubsystem)) return;
+
+	// Unversioned holders can't tell us when a menu computed now goes stale, so it couldn't be used for the click
+	UObject* ContextHolder = HoveredContextHolder.Get();
+	if (!ContextHolder || !HoveredContextVersion.IsVersioned()) return;
+
+	if (GetWorld()->GetTimeSeconds() - HoverStartTime < HoverDwellTime) return;
+	
+	ActionSubsystem->PrecomputeContextMenu(ContextHolder, DefaultActions);
+	bHoverMenuPrecomputed = true;
+}
+
 void UContext_SystemComponent::OpenContextMenu() {
 	const APlayerController* PlayerController = GetCurrentActorController();
 	if (!IsValid(PlayerController)) {
 		return;
 	}
-	
+
 	// world context is enabled - we want to use world items 
 	if(ActionSubsystem->CheckSourceEnabled(EContext_ContextSource::World)) {
-		TArray<FHitResult> Hits;
-
-		ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
-		if (!IsValid(LocalPlayer) || !LocalPlayer->ViewportClient) return;
-
 		FVector2D MousePos;
-		if (!LocalPlayer->ViewportClient->GetMousePosition(MousePos)) return;
-		
-		// Convert mouse position to 3D raycast start and end points
 		FVector WorldLocation, WorldDirection;
-		PlayerController->DeprojectMousePositionToWorld(WorldLocation, WorldDirection);
+		if (!GetCursorRay(PlayerController, MousePos, WorldLocation, WorldDirection)) return;
+
+		// Cleared by the menu when it shows up, or by ShowContextMenuForHits if there's nothing to show
+		ActionSubsystem->MarkMenuOpenRequested();
 
 		FCollisionQueryParams TraceParams = FCollisionQueryParams(FName(TEXT("")), true, PlayerController);
 
 		FVector Start = WorldLocation;
-		FVector End = Start + WorldDirection * 10000.0f;
-		
-		if (PlayerController->GetWorld()->LineTraceMultiByChannel(Hits, Start, End, ECC_Visibility, TraceParams)) {
-
-			TArray<FContextEntryPackage> ContextPackage;
-			TArray<AActor*> HitActors;
-			FVector FirstImpactPoint = Hits[0].ImpactPoint;
-
-			// only get actors once
-			for (auto Hit : Hits) {
-				HitActors.AddUnique(Hit.GetActor());
-			}
-
-			// cleaned actors
-			for (auto HitActor : HitActors) {
-
-				UObject* ContextObject = ActionSubsystem->RetrieveValidContextHolderFromObjectNonConst(HitActor);
-				if (!IsValid(ContextObject)) continue;
-				
-				// get entries + default
-				TSet<UContext_ActionEntry*> ActionEntries = ActionSubsystem->GetValidContextEntriesForObject(ContextObject);
-				ActionEntries.Append(DefaultActions);
-
-				FContextEntryPackage EntryPackage(ContextObject, ActionEntries);
-				ContextPackage.Add(EntryPackage);
-				
-			}
-
-			if (ContextPackage.Num() != 0) {
-				ActionSubsystem->ShowContextMenu(ContextPackage, FirstImpactPoint);
-			}
+		FVector End = Start + WorldDirection * MaxTraceDistance;
+
+		// Results come back next frame, in OnMenuTraceCompleted. Starting a new trace makes the previous one stale
+		if (bUseAsyncTrace) {
+			PendingMenuTrace = PlayerController->GetWorld()->AsyncLineTraceByChannel(
+				EAsyncTraceType::Multi, Start, End, ContextTraceChannel, TraceParams,
+				FCollisionResponseParams::DefaultResponseParam, &MenuTraceDelegate);
+			return;
+		}
+
+		TArray<FHitResult> Hits;
+		{
+			CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_OpenMenuTrace);
+			PlayerController->GetWorld()->LineTraceMultiByChannel(Hits, Start, End, ContextTraceChannel, TraceParams);
 		}
+		
+		ShowContextMenuForHits(Hits);
 		return;
 	}
 
 	
 }
 
+void UContext_SystemComponent::OnMenuTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum) {
+	if (TraceHandle != PendingMenuTrace) return;
+	PendingMenuTrace = FTraceHandle();
+
+	if (!IsValid(ActionSubsystem)) return;
+	
+	if (!ActionSubsystem->CheckSourceEnabled(EContext_ContextSource::World)) {
+		ActionSubsystem->ConsumeMenuOpenRequest();
+		return;
+	}
+	
+	ShowContextMenuForHits(TraceDatum.OutHits);
+}
+
+void UContext_SystemComponent::ShowContextMenuForHits(const TArray<FHitResult>& Hits) {
+	// No menu is shown, so the request mustn't be measured by the next one that is
+	if (Hits.IsEmpty()) {
+		ActionSubsystem->ConsumeMenuOpenRequest();
+		return;
+	}
+
+	const FHitResult& FirstHit = Hits[0];
+	
+	TArray<UObject*, TInlineAllocator<16>> HitActors;
+	TSet<const AActor*, DefaultKeyFuncs<const AActor*>, TInlineSetAllocator<16>> SeenActors;
+	
+	// only get actors once
+	for (const FHitResult& Hit : Hits) {
+		// Hits are sorted by distance, so everything after this is further away
+		if (OcclusionCutoffDistance > 0.f && Hit.Distance - FirstHit.Distance > OcclusionCutoffDistance) break;
+		
+		AActor* HitActor = Hit.GetActor();
+		if (!HitActor) continue;
+		
+		bool bAlreadySeen = false;
+		SeenActors.Add(HitActor, &bAlreadySeen);
+		if (!bAlreadySeen) {
+			HitActors.Add(HitActor);
+		}
+	}
+
+	// A single holder hovered long enough already has its menu, otherwise
+	// get entries + default for every holder hit, in one pass
+	TArray<FContextEntryPackage> ContextPackage;
+	if (HitActors.Num() != 1 || !ActionSubsystem->FindPrecomputedContextMenu(HitActors[0], DefaultActions, ContextPackage)) {
+		ActionSubsystem->GetContextEntryPackagesForObjects(HitActors, DefaultActions, ContextPackage);
+	}
+
+	if (ContextPackage.Num() != 0) {
+		ActionSubsystem->ShowContextMenu(ContextPackage, FirstHit.ImpactPoint);
+	} else {
+		ActionSubsystem->ConsumeMenuOpenRequest();
+	}
+}
+
 APlayerController* UContext_SystemComponent::GetCurrentActorController() const {
 	if (!IsValid(ActionSubsystem)) {
 		UE_LOG(LogContextSystem, Log, TEXT("Oops! Looks like you're trying to open the context menu from an invalid context.\n"
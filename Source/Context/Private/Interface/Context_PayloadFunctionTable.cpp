@@ -0,0 +1,116 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interface/Context_PayloadFunctionTable.h"
+
+#include "Actions/Context_Action.h"
+#include "Actions/Context_ActionEntry.h"
+
+TMap<TObjectKey<UClass>, FContext_PayloadFunctionTable::FClassTable> FContext_PayloadFunctionTable::ClassTables;
+
+UFunction* FContext_PayloadFunctionTable::FindPayloadFunction(const UClass* Class, const UContext_ActionEntry* Entry) {
+	if (!IsValid(Class) || !IsValid(Entry)) {
+		return nullptr;
+	}
+	
+	check(IsInGameThread());
+
+	FClassTable& Table = ClassTables.FindOrAdd(Class);
+	if (const TWeakObjectPtr<UFunction>* Found = Table.Functions.Find(Entry)) {
+		// A stale function means the class was recompiled, resolve it again
+		if (UFunction* Function = Found->Get()) {
+			return Function;
+		}
+#if !WITH_EDITOR
+		return nullptr;
+#endif
+	}
+
+	FName DisplayFunctionName, ExpectedFunctionName;
+	Entry->GetPayloadFunctionNames(DisplayFunctionName, ExpectedFunctionName);
+	
+	UFunction* Function = Class->FindFunctionByName(DisplayFunctionName);
+	if (!IsValid(Function)) {
+		Function = Class->FindFunctionByName(ExpectedFunctionName);
+	}
+
+#if WITH_EDITOR
+	// Functions can be added while editing, so don't remember misses
+	if (!Function) {
+		return nullptr;
+	}
+#endif
+	
+	Table.Functions.Add(Entry, Function);
+	return Function;
+}
+
+void FContext_PayloadFunctionTable::WarmClass(
+	const UClass* Class,
+	const TSet<UContext_ActionEntry*>& Entries,
+	const TArray<UContext_ActionEntry*>& PrimaryEntries) {
+	
+	for (const UContext_ActionEntry* Entry : Entries) {
+		FindPayloadFunction(Class, Entry);
+	}
+	for (const UContext_ActionEntry* Entry : PrimaryEntries) {
+		FindPayloadFunction(Class, Entry);
+	}
+}
+
+void FContext_PayloadFunctionTable::Reset() {
+	ClassTables.Empty();
+}
+
+UContext_ActionEntry* FContext_PayloadClassIndex::Find(
+	const UClass* PayloadClass,
+	const TSet<UContext_ActionEntry*>& Entries,
+	const TArray<UContext_ActionEntry*>& PrimaryEntries) {
+
+	if (bDirty) {
+		Rebuild(Entries, PrimaryEntries);
+	}
+
+	if (!PayloadClass || EntriesByPayloadClass.IsEmpty()) {
+		return nullptr;
+	}
+
+	UContext_ActionEntry* const* Found = EntriesByPayloadClass.Find(FSoftObjectPath(PayloadClass));
+	return Found ? *Found : nullptr;
+}
+
+void FContext_PayloadClassIndex::Rebuild(
+	const TSet<UContext_ActionEntry*>& Entries,
+	const TArray<UContext_ActionEntry*>& PrimaryEntries) {
+
+	EntriesByPayloadClass.Reset();
+	bool bComplete = true;
+
+	auto AddEntry = [this, &bComplete](UContext_ActionEntry* Entry) {
+		if (!IsValid(Entry)) return;
+
+		// Unrecorded and not streamed in yet, rebuild on the next lookup in case it has been by then
+		if (!Entry->IsActionPayloadClassKnown()) {
+			bComplete = false;
+			return;
+		}
+		
+		// Recorded on the entry, so actions that weren't streamed in yet don't have to be loaded
+		const FSoftObjectPath PayloadClass = Entry->GetActionPayloadClassPath();
+		if (PayloadClass.IsNull()) return;
+
+		// First entry providing a payload class wins
+		if (!EntriesByPayloadClass.Contains(PayloadClass)) {
+			EntriesByPayloadClass.Add(PayloadClass, Entry);
+		}
+	};
+
+	for (UContext_ActionEntry* Entry : Entries) {
+		AddEntry(Entry);
+	}
+	for (UContext_ActionEntry* Entry : PrimaryEntries) {
+		AddEntry(Entry);
+	}
+
+	bDirty = !bComplete;
+}
@@ -0,0 +1,159 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Spatial/Context_HolderSpatialHash.h"
+
+FContext_HolderSpatialHash::FContext_HolderSpatialHash(const float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.f)) {
+}
+
+void FContext_HolderSpatialHash::Update(UObject* Holder, const FVector& Location) {
+	const FIntVector Cell = GetCell(Location);
+	
+	if (const int32* ExistingIndex = ItemIndices.Find(Holder)) {
+		FItem& Item = Items[*ExistingIndex];
+		Item.Location = Location;
+
+		// Most movement stays within the same cell, which only needs the location updated
+		if (Item.Cell != Cell) {
+			RemoveFromCell(Item.Cell, *ExistingIndex);
+			AddToCell(Cell, *ExistingIndex);
+			Item.Cell = Cell;
+		}
+		return;
+	}
+
+	FItem Item;
+	Item.Holder = Holder;
+	Item.Location = Location;
+	Item.Cell = Cell;
+	
+	const int32 ItemIndex = Items.Add(MoveTemp(Item));
+	ItemIndices.Add(Holder, ItemIndex);
+	AddToCell(Cell, ItemIndex);
+}
+
+void FContext_HolderSpatialHash::Remove(const UObject* Holder) {
+	int32 ItemIndex = INDEX_NONE;
+	if (!ItemIndices.RemoveAndCopyValue(Holder, ItemIndex)) {
+		return;
+	}
+
+	RemoveFromCell(Items[ItemIndex].Cell, ItemIndex);
+	Items.RemoveAt(ItemIndex);
+}
+
+void FContext_HolderSpatialHash::Reset() {
+	Items.Reset();
+	ItemIndices.Reset();
+	Cells.Reset();
+}
+
+FIntVector FContext_HolderSpatialHash::GetCell(const FVector& Location) const {
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+template <typename VisitorType>
+void FContext_HolderSpatialHash::ForEachItemInCells(const FBox& Box, VisitorType&& Visitor) const {
+	const FIntVector MinCell = GetCell(Box.Min);
+	const FIntVector MaxCell = GetCell(Box.Max);
+	const int64 NumCellsInBox =
+		int64(MaxCell.X - MinCell.X + 1) *
+		int64(MaxCell.Y - MinCell.Y + 1) *
+		int64(MaxCell.Z - MinCell.Z + 1);
+
+	// Huge boxes cover more cells than are actually occupied, so walk the occupied ones instead
+	if (NumCellsInBox > Cells.Num()) {
+		for (const TPair<FIntVector, TArray<int32>>& Cell : Cells) {
+			if (Cell.Key.X < MinCell.X || Cell.Key.X > MaxCell.X
+				|| Cell.Key.Y < MinCell.Y || Cell.Key.Y > MaxCell.Y
+				|| Cell.Key.Z < MinCell.Z || Cell.Key.Z > MaxCell.Z) {
+				continue;
+			}
+			
+			for (const int32 ItemIndex : Cell.Value) {
+				Visitor(Items[ItemIndex]);
+			}
+		}
+		return;
+	}
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X) {
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y) {
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z) {
+				if (const TArray<int32>* CellItems = Cells.Find(FIntVector(X, Y, Z))) {
+					for (const int32 ItemIndex : *CellItems) {
+						Visitor(Items[ItemIndex]);
+					}
+				}
+			}
+		}
+	}
+}
+
+void FContext_HolderSpatialHash::QueryBox(const FBox& Box, TArray<UObject*>& OutHolders) const {
+	ForEachItemInCells(Box, [&](const FItem& Item) {
+		if (Box.IsInsideOrOn(Item.Location)) {
+			if (UObject* Holder = Item.Holder.Get()) {
+				OutHolders.Add(Holder);
+			}
+		}
+	});
+}
+
+void FContext_HolderSpatialHash::QuerySphere(const FVector& Center, const float Radius, TArray<UObject*>& OutHolders) const {
+	const double RadiusSquared = FMath::Square(Radius);
+	
+	ForEachItemInCells(FBox::BuildAABB(Center, FVector(Radius)), [&](const FItem& Item) {
+		if (FVector::DistSquared(Center, Item.Location) <= RadiusSquared) {
+			if (UObject* Holder = Item.Holder.Get()) {
+				OutHolders.Add(Holder);
+			}
+		}
+	});
+}
+
+void FContext_HolderSpatialHash::QueryCone(
+	const FVector& Origin,
+	const FVector& Direction,
+	const float Length,
+	const float HalfAngleRadians,
+	TArray<UObject*>& OutHolders) const {
+
+	const FVector ConeDirection = Direction.GetSafeNormal();
+	const double LengthSquared = FMath::Square(Length);
+	const double CosHalfAngle = FMath::Cos(HalfAngleRadians);
+	
+	ForEachItemInCells(FBox::BuildAABB(Origin, FVector(Length)), [&](const FItem& Item) {
+		const FVector ToItem = Item.Location - Origin;
+		const double DistanceSquared = ToItem.SizeSquared();
+		if (DistanceSquared > LengthSquared) return;
+
+		// Anything sitting on the tip of the cone is inside it
+		if (DistanceSquared > UE_SMALL_NUMBER
+			&& FVector::DotProduct(ToItem, ConeDirection) < CosHalfAngle * FMath::Sqrt(DistanceSquared)) {
+			return;
+		}
+		
+		if (UObject* Holder = Item.Holder.Get()) {
+			OutHolders.Add(Holder);
+		}
+	});
+}
+
+void FContext_HolderSpatialHash::AddToCell(const FIntVector& Cell, const int32 ItemIndex) {
+	Cells.FindOrAdd(Cell).Add(ItemIndex);
+}
+
+void FContext_HolderSpatialHash::RemoveFromCell(const FIntVector& Cell, const int32 ItemIndex) {
+	TArray<int32>* CellItems = Cells.Find(Cell);
+	if (!CellItems) return;
+	
+	CellItems->RemoveSingleSwap(ItemIndex);
+	if (CellItems->IsEmpty()) {
+		Cells.Remove(Cell);
+	}
+}
@@ -19,7 +19,15 @@ void UContext_EntryButton::Setup(AActor* Instigator, const UContext_ActionEntry*
 	ContextAction = ContextEntry;
 	InstigatingActor = Instigator;
 	ContextObject = ContextHolder;
-	//OnClicked.Add(this, &UContext_EntryButton::ActionSelected);
+
+	// Buttons are reused by the menu, so only bind the first time
+	OnClicked.AddUniqueDynamic(this, &UContext_EntryButton::ActionSelected);
+}
+
+void UContext_EntryButton::Reset() {
+	ContextAction = nullptr;
+	InstigatingActor = nullptr;
+	ContextObject = nullptr;
 }
 
 void UContext_EntryButton::ActionSelected() {
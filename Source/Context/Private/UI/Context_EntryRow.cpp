@@ -0,0 +1,25 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/Context_EntryRow.h"
+
+#include "Actions/Context_ActionEntry.h"
+#include "Interface/Context_Holder.h"
+#include "UI/Context_MenuEntryData.h"
+
+void UContext_EntryRow::NativeOnListItemObjectSet(UObject* ListItemObject) {
+	IUserObjectListEntry::NativeOnListItemObjectSet(ListItemObject);
+
+	const UContext_MenuEntryData* EntryData = Cast<UContext_MenuEntryData>(ListItemObject);
+	if (!EntryData || !IsValid(EntryData->ContextEntry)) return;
+	
+	const UContext_ActionEntry* ContextEntry = EntryData->ContextEntry;
+	ContextActionName->SetText(ContextEntry->ActionName);
+
+	if (ContextEntry->bDisplayEntityName && EntryData->ContextHolder.GetObject()) {
+		ContextEntityName->SetVisibility(ESlateVisibility::Visible);
+		ContextEntityName->SetText(IContext_Holder::Execute_GetDisplayName(EntryData->ContextHolder.GetObject()));
+	} else {
+		ContextEntityName->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
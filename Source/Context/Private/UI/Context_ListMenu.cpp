@@ -0,0 +1,65 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/Context_ListMenu.h"
+
+#include "Actions/Context_ActionSubsystem.h"
+#include "Components/ListView.h"
+#include "UI/Context_MenuEntryData.h"
+
+void UContext_ListMenu::NativeOnInitialized() {
+	Super::NativeOnInitialized();
+
+	if (ContextEntryList.IsValid()) {
+		ContextEntryList->OnItemClicked().AddUObject(this, &UContext_ListMenu::EntryClicked);
+	}
+}
+
+void UContext_ListMenu::PopulateEntries(const TArray<FContextEntryPackage>& ContextEntryPackage) {
+	if (!ContextEntryList.IsValid()) {
+		UE_LOG(LogContextMenu, Warning, TEXT("Context list menu %ls has no entry list"), *GetName());
+		return;
+	}
+	
+	AActor* Instigator = GetOwningPlayerPawn();
+	
+	ListItems.Reset();
+	for (const auto& [ContextHolder, ContextEntries] : ContextEntryPackage) {
+		for (const auto ContextEntry : ContextEntries) {
+			if (!EntryDataPool.IsValidIndex(NumActiveEntryData)) {
+				EntryDataPool.Add(NewObject<UContext_MenuEntryData>(this));
+			}
+
+			UContext_MenuEntryData* EntryData = EntryDataPool[NumActiveEntryData++];
+			EntryData->Setup(Instigator, ContextEntry, ContextHolder);
+			ListItems.Add(EntryData);
+		}
+	}
+
+	ContextEntryList->SetListItems(ListItems);
+	ContextEntryList->ScrollToTop();
+}
+
+void UContext_ListMenu::ReleaseEntries() {
+	Super::ReleaseEntries();
+	
+	if (ContextEntryList.IsValid()) {
+		ContextEntryList->ClearListItems();
+	}
+
+	for (int32 Index = 0; Index < NumActiveEntryData; Index++) {
+		EntryDataPool[Index]->Reset();
+	}
+
+	ListItems.Reset();
+	NumActiveEntryData = 0;
+}
+
+void UContext_ListMenu::EntryClicked(UObject* Item) {
+	const UContext_MenuEntryData* EntryData = Cast<UContext_MenuEntryData>(Item);
+	if (!EntryData || !IsValid(EntryData->ContextEntry)) return;
+
+	UContext_ActionSubsystem* ActionSubsystem = GetGameInstance()->GetSubsystem<UContext_ActionSubsystem>();
+	ActionSubsystem->ExecuteAction(EntryData->ContextHolder, EntryData->ContextEntry, EntryData->InstigatingActor);
+	ActionSubsystem->HideContextMenu();
+}
@@ -4,7 +4,13 @@
 #include "UI/Context_Menu.h"
 
 #include "Actions/Context_ActionSubsystem.h"
+#include "Context_Stats.h"
+#include "TimerManager.h"
+#include "Blueprint/WidgetTree.h"
+#include "Camera/PlayerCameraManager.h"
 #include "Components/VerticalBox.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
 #include "UI/Context_EntryButton.h"
 
 void UContext_Menu::ShowMenu(
@@ -13,6 +19,9 @@ void UContext_Menu::ShowMenu(
 	const bool bRemoveDPIScale) {
 
 	WorldLocation = WorldSpawnLocation;
+
+	// Make sure the first update projects again, since we don't know the view this was projected with
+	LastProjectedViewportSize = FIntPoint::ZeroValue;
 	
 	FVector2D ScreenLocation;
 	GetWorld()->GetFirstPlayerController()->ProjectWorldLocationToScreen(WorldLocation,ScreenLocation);
@@ -32,43 +41,196 @@ void UContext_Menu::ShowMenuInternal(
 	const FVector2D ScreenSpaceLocation,
     const TArray<FContextEntryPackage>& ContextEntryPackage,
     const bool bRemoveDPIScale) {
+
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_ShowMenu);
+	INC_DWORD_STAT(STAT_Context_NumMenusShown);
+
+	if (const UGameInstance* GameInstance = GetGameInstance()) {
+		if (UContext_ActionSubsystem* Subsystem = GameInstance->GetSubsystem<UContext_ActionSubsystem>()) {
+			MenuRequestCycles = Subsystem->ConsumeMenuOpenRequest();
+		}
+	}
 	
 	SetPositionInViewport(ScreenSpaceLocation, bRemoveDPIScale);
 
-	ContextEntryButtons.Empty();
-	ContextButtonContainer->ClearChildren();
+	// Entries from the last menu are cleared, and set up again below
+	ReleaseEntries();
+	if (const UWorld* World = GetWorld()) {
+		World->GetTimerManager().ClearTimer(TrimEntryButtonPoolHandle);
+	}
+
+	PopulateEntries(ContextEntryPackage);
+	
+	SetVisibility(ESlateVisibility::Visible);
+	StartUpdating();
+}
 
+void UContext_Menu::PopulateEntries(const TArray<FContextEntryPackage>& ContextEntryPackage) {
 	// loop through object found
-	for (const auto [ContextHolder, ContextEntries] : ContextEntryPackage) {
+	for (const auto& [ContextHolder, ContextEntries] : ContextEntryPackage) {
 		for (const auto ContextEntry : ContextEntries) {
-			//UContext_EntryButton* ContextEntryButtonInstance = CreateWidget<UContext_EntryButton>(this, EntryButtonTemplate);
-			//ContextEntryButtonInstance->Setup(GetOwningPlayerPawn(), ContextEntry, ContextHolder);
-			//ContextButtonContainer->AddChildToVerticalBox(ContextEntryButtonInstance);
-			//ContextEntryButtons.Add(ContextEntryButtonInstance);	
+			UContext_EntryButton* EntryButton = GetOrCreateEntryButton(NumActiveEntryButtons);
+			if (!EntryButton) return;
+			
+			EntryButton->Setup(GetOwningPlayerPawn(), ContextEntry, ContextHolder);
+			EntryButton->SetVisibility(ESlateVisibility::Visible);
+			NumActiveEntryButtons++;
 		}
 	}
-	
-	SetVisibility(ESlateVisibility::Visible);
+}
+
+void UContext_Menu::ReleaseEntries() {
+	ReleaseEntryButtons();
 }
 
 void UContext_Menu::HideMenu() {
-	for(const auto EntryButton : ContextEntryButtons) {
-		EntryButton->RemoveFromParent();
-	}
+	StopUpdating();
+	ReleaseEntries();
 
-	ContextEntryButtons.Empty();
-	ContextButtonContainer->ClearChildren();
+	if (EntryButtonPoolTrimDelay > 0.f) {
+		if (const UWorld* World = GetWorld()) {
+			World->GetTimerManager().SetTimer(TrimEntryButtonPoolHandle, this, &UContext_Menu::TrimEntryButtonPool, EntryButtonPoolTrimDelay);
+		}
+	}
 
 	SetVisibility(ESlateVisibility::Collapsed);
 }
 
+void UContext_Menu::NativeDestruct() {
+	StopUpdating();
+	
+	if (const UWorld* World = GetWorld()) {
+		World->GetTimerManager().ClearTimer(TrimEntryButtonPoolHandle);
+	}
+	
+	Super::NativeDestruct();
+}
+
+void UContext_Menu::PrewarmEntryButtons(const int32 NumButtons) {
+	if (NumButtons > 0) {
+		GetOrCreateEntryButton(NumButtons - 1);
+	}
+}
+
+UContext_EntryButton* UContext_Menu::GetOrCreateEntryButton(const int32 Index) {
+	if (ContextEntryButtons.IsValidIndex(Index)) {
+		return ContextEntryButtons[Index];
+	}
+
+	if (!EntryButtonTemplate || !ContextButtonContainer.IsValid()) {
+		UE_LOG(LogContextMenu, Warning, TEXT("Context menu %ls has no entry button template or button container"), *GetName());
+		return nullptr;
+	}
+	
+	// Grow the pool. New buttons stay in the container for good, and are only collapsed when unused
+	while (ContextEntryButtons.Num() <= Index) {
+		UContext_EntryButton* EntryButton = WidgetTree->ConstructWidget<UContext_EntryButton>(EntryButtonTemplate);
+		EntryButton->SetVisibility(ESlateVisibility::Collapsed);
+		ContextButtonContainer->AddChildToVerticalBox(EntryButton);
+		ContextEntryButtons.Add(EntryButton);
+	}
+
+	return ContextEntryButtons[Index];
+}
+
+void UContext_Menu::ReleaseEntryButtons() {
+	for (int32 Index = 0; Index < NumActiveEntryButtons; Index++) {
+		UContext_EntryButton* EntryButton = ContextEntryButtons[Index];
+		EntryButton->SetVisibility(ESlateVisibility::Collapsed);
+		EntryButton->Reset();
+	}
+
+	NumActiveEntryButtons = 0;
+}
+
+void UContext_Menu::TrimEntryButtonPool() {
+	const int32 NumToKeep = FMath::Max(MinPooledEntryButtons, NumActiveEntryButtons);
+	
+	while (ContextEntryButtons.Num() > NumToKeep) {
+		ContextEntryButtons.Pop()->RemoveFromParent();
+	}
+}
+
 void UContext_Menu::NativeTick(const FGeometry& MyGeometry, float InDeltaTime) {
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
-	if (bShouldBeStaticOnScreen || WorldLocation == FVector::Zero()) return;
+	if (bUpdating && !UpdateMenu()) {
+		StopUpdating();
+	}
+}
+
+void UContext_Menu::StartUpdating() {
+	// Static menus only need the one update that records latency
+	if (!IsWorldAnchored() && MenuRequestCycles == 0) {
+		StopUpdating();
+		return;
+	}
+	
+	bUpdating = true;
+	SetTickEnabled(true);
+}
+
+void UContext_Menu::StopUpdating() {
+	bUpdating = false;
+	SetTickEnabled(false);
+}
+
+void UContext_Menu::SetTickEnabled(bool bEnabled) {
+	// Only we know the menu is idle, Blueprint ticks, animations and latent actions still need ticking
+	if (!bEnabled) {
+		const UWorld* World = GetWorld();
+		bEnabled = bHasScriptImplementedTick
+			|| IsAnyAnimationPlaying()
+			|| (World && World->GetLatentActionManager().GetNumActionsForObject(this) > 0);
+	}
+	
+	if (const TSharedPtr<SWidget> Widget = GetCachedWidget()) {
+		Widget->SetCanTick(bEnabled);
+	}
+}
+
+bool UContext_Menu::UpdateMenu() {
+	// first update after showing - the menu is on screen, so input to visible latency can be recorded
+	if (MenuRequestCycles != 0) {
+		const float LatencyMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - MenuRequestCycles));
+		SET_FLOAT_STAT(STAT_Context_InputToMenuVisibleMs, LatencyMs);
+		TRACE_COUNTER_SET(Context_InputToMenuVisibleMs, LatencyMs);
+		MenuRequestCycles = 0;
+	}
+
+	if (!IsWorldAnchored() || !IsVisible()) {
+		return false;
+	}
+
+	UpdateWorldAnchor();
+	return true;
+}
+
+void UContext_Menu::UpdateWorldAnchor() {
+	const UWorld* World = GetWorld();
+	APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	if (!PlayerController) return;
+
+	if (AnchorMode == EContext_MenuAnchorMode::OnViewChange && PlayerController->PlayerCameraManager) {
+		const FMinimalViewInfo& View = PlayerController->PlayerCameraManager->GetCameraCacheView();
+		
+		FIntPoint ViewportSize;
+		PlayerController->GetViewportSize(ViewportSize.X, ViewportSize.Y);
+
+		const bool bViewChanged = ViewportSize != LastProjectedViewportSize
+			|| FVector::DistSquared(View.Location, LastProjectedCameraLocation) > FMath::Square(ReprojectLocationThreshold)
+			|| !View.Rotation.Equals(LastProjectedCameraRotation, ReprojectAngleThreshold)
+			|| !FMath::IsNearlyEqual(View.FOV, LastProjectedFOV, ReprojectAngleThreshold);
+		
+		if (!bViewChanged) return;
+
+		LastProjectedCameraLocation = View.Location;
+		LastProjectedCameraRotation = View.Rotation;
+		LastProjectedFOV = View.FOV;
+		LastProjectedViewportSize = ViewportSize;
+	}
 
 	FVector2D ScreenLocation;
-	GetWorld()->GetFirstPlayerController()->ProjectWorldLocationToScreen(WorldLocation,ScreenLocation);
+	PlayerController->ProjectWorldLocationToScreen(WorldLocation,ScreenLocation);
 	SetPositionInViewport(ScreenLocation, true);
 }
-
@@ -3,11 +3,13 @@
 
 #include "..\..\Public\UI\Context_UIWidgetBase.h"
 
+#include "Context_Stats.h"
 #include "Actions/Context_Action.h"
 #include "Actions/Context_ActionEntry.h"
 #include "Actions/Context_ActionSubsystem.h"
 #include "Blueprint/WidgetLayoutLibrary.h"
 #include "Components/Context_HolderComponent.h"
+#include "Interface/Context_PayloadFunctionTable.h"
 #include "Kismet/GameplayStatics.h"
 #include "Misc/DataValidation.h"
 
@@ -17,14 +19,18 @@ FReply UContext_UIWidgetBase::NativeOnMouseButtonDown(const FGeometry& InGeometr
 		// only proceed if UI context is enabled
 		if (Subsystem->CheckSourceEnabled(EContext_ContextSource::UI)) {
 			Subsystem->UIContextElement = this;
+			Subsystem->MarkMenuOpenRequested();
 
 			const FVector2D MousePos = UWidgetLayoutLibrary::GetViewportWidgetGeometry(this).AbsoluteToLocal(InMouseEvent.GetScreenSpacePosition());
 
-			const TSet<UContext_ActionEntry*> ActionEntries = Subsystem->GetValidContextEntriesForObject(this);
-
-			const FContextEntryPackage EntryPackage(this, ActionEntries);
+			// Use the menu computed when the cursor entered, if nothing changed since
 			TArray<FContextEntryPackage> EntryPackages;
-			EntryPackages.Add(EntryPackage);
+			if (!Subsystem->FindPrecomputedContextMenu(this, {}, EntryPackages)) {
+				const TSet<UContext_ActionEntry*> ActionEntries = Subsystem->GetValidContextEntriesForObject(this);
+
+				const FContextEntryPackage EntryPackage(this, ActionEntries);
+				EntryPackages.Add(EntryPackage);
+			}
 			Subsystem->ShowUIContextMenu(MousePos, EntryPackages);
 			return FReply::Handled();;
 		}
@@ -43,7 +49,11 @@ FReply UContext_UIWidgetBase::NativeOnMouseButtonDoubleClick(const FGeometry& In
 
 		Subsystem->UIContextElement = this;
 
-		const UContext_ActionEntry* ActionEntry = Subsystem->GetPrimaryContextEntryForObject(this);
+		UContext_ActionEntry* ActionEntry = nullptr;
+		if (!Subsystem->FindPrecomputedPrimaryEntry(this, ActionEntry)) {
+			ActionEntry = Subsystem->GetPrimaryContextEntryForObject(this);
+		}
+		
 		if (IsValid(ActionEntry)) {
 			return Subsystem->ExecuteAction(this, ActionEntry, GetOwningPlayerPawn()) ? FReply::Handled() : FReply::Unhandled();
 		}
@@ -51,16 +61,62 @@ FReply UContext_UIWidgetBase::NativeOnMouseButtonDoubleClick(const FGeometry& In
 	return FReply::Unhandled();
 }
 
+void UContext_UIWidgetBase::NativeOnMouseEnter(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) {
+	Super::NativeOnMouseEnter(InGeometry, InMouseEvent);
+
+	if (!bPrecomputeMenuOnHover) return;
+	
+	UContext_ActionSubsystem* Subsystem = GetGameInstance()->GetSubsystem<UContext_ActionSubsystem>();
+	if (Subsystem && Subsystem->CheckSourceEnabled(EContext_ContextSource::UI)) {
+		Subsystem->PrecomputeContextMenu(this, {});
+	}
+}
+
+void UContext_UIWidgetBase::NativeConstruct() {
+	Super::NativeConstruct();
+	InvalidateCachedContext();
+
+	// Resolve payload functions now rather than on the first execution
+	FContext_PayloadFunctionTable::WarmClass(GetClass(), ContextEntries, PrimaryContextEntryPriority);
+}
+
+void UContext_UIWidgetBase::NativeDestruct() {
+	InvalidateCachedContext();
+	Super::NativeDestruct();
+}
+
 void UContext_UIWidgetBase::GiveTag(FGameplayTagContainer Tags) {
 	DefaultTags.AppendTags(Tags);
+	MarkContextDirty();
 }
 
 void UContext_UIWidgetBase::RemoveTag(FGameplayTagContainer Tags) {
 	DefaultTags.RemoveTags(Tags);
+	MarkContextDirty();
 }
 
 void UContext_UIWidgetBase::ClearTags() {
 	DefaultTags.Reset();
+	MarkContextDirty();
+}
+
+void UContext_UIWidgetBase::SetContextEntries(const TSet<UContext_ActionEntry*>& Entries) {
+	ContextEntries = Entries;
+	PayloadClassIndex.MarkDirty();
+	MarkContextDirty();
+}
+
+void UContext_UIWidgetBase::SetPrimaryContextEntryPriority(const TArray<UContext_ActionEntry*>& Entries) {
+	PrimaryContextEntryPriority = Entries;
+	PayloadClassIndex.MarkDirty();
+	MarkContextDirty();
+}
+
+void UContext_UIWidgetBase::MarkContextDirty() {
+	// 0 is reserved for unversioned holders
+	if (++ContextVersion == 0) {
+		ContextVersion = 1;
+	}
 }
 
 FVector UContext_UIWidgetBase::GetPosition_Implementation() const {
@@ -78,22 +134,26 @@ TSet<UContext_ActionEntry*> UContext_UIWidgetBase::GetActionEntries_Implementati
 	return ContextEntries;
 }
 
+const TSet<UContext_ActionEntry*>* UContext_UIWidgetBase::GetActionEntriesView() const {
+	// A Blueprint GetActionEntries may not return ContextEntries
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IContext_Holder, GetActionEntries))) {
+		return nullptr;
+	}
+	return &ContextEntries;
+}
+
 const UContext_ActionPayloadBase* UContext_UIWidgetBase::RequestPayloadOfType_Implementation(
 	TSubclassOf<UContext_ActionPayloadBase> PayloadType) const {
-		TSet<UContext_ActionEntry*> Entries = ContextEntries.Union(TSet(PrimaryContextEntryPriority));
-		for (const auto Entry : Entries) {
-			if (Entry->Action->GetDefaultObject<UContext_Action>()->PayloadClass == PayloadType) {
-				return Execute_RequestPayload(this, Entry);
-			}
-		}
-		return nullptr;
+
+	const UContext_ActionEntry* Entry = PayloadClassIndex.Find(PayloadType, ContextEntries, PrimaryContextEntryPriority);
+	return Entry ? Execute_RequestPayload(this, Entry) : nullptr;
 }
 
 const UContext_ActionPayloadBase* UContext_UIWidgetBase::RequestPayload_Implementation(
 	const UContext_ActionEntry* ActionEntry) const {
 		
 	FName ExpectedFunctionName;
-	UFunction* PayloadFunc = GetFunctionForAction(ActionEntry->ActionName.ToString(), ExpectedFunctionName);
+	UFunction* PayloadFunc = GetFunctionForAction(ActionEntry, ExpectedFunctionName);
 	
 	// Function should be valid, if not then it hasn't been defined
 	if (!IsValid(PayloadFunc)) {
@@ -109,6 +169,10 @@ const UContext_ActionPayloadBase* UContext_UIWidgetBase::RequestPayload_Implemen
 		UContext_ActionPayloadBase* ReturnValue;
 	};
 
+	CONTEXT_SCOPE_CYCLE_COUNTER(STAT_Context_PayloadRequest);
+	INC_DWORD_STAT(STAT_Context_NumPayloadRequests);
+	TRACE_COUNTER_INCREMENT(Context_PayloadRequests);
+
 	UContext_UIWidgetBase* SelfWidget = const_cast<UContext_UIWidgetBase*>(this);
 	FPayloadFuncParams Params;
 	SelfWidget->ProcessEvent(PayloadFunc, &Params);
@@ -116,6 +180,16 @@ const UContext_ActionPayloadBase* UContext_UIWidgetBase::RequestPayload_Implemen
 	return Params.ReturnValue;
 }
 
+const UFunction* UContext_UIWidgetBase::GetPayloadFunction(const UContext_ActionEntry* ActionEntry) const {
+	// A Blueprint RequestPayload may not call the payload function at all
+	if (GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(IContext_Holder, RequestPayload))) {
+		return nullptr;
+	}
+
+	FName ExpectedFunctionName;
+	return GetFunctionForAction(ActionEntry, ExpectedFunctionName);
+}
+
 TArray<UContext_ActionEntry*> UContext_UIWidgetBase::GetPrimaryActionEntries_Implementation() const {
 	return PrimaryContextEntryPriority;
 }
@@ -124,20 +198,24 @@ FText UContext_UIWidgetBase::GetDisplayName_Implementation() const {
 	return FText::FromString(TEXT("UNHANDLED_UI_NAME"));
 }
 
-UFunction* UContext_UIWidgetBase::GetFunctionForAction(const FString& ActionName, FName& ExpectedFunctionName) const {
+UFunction* UContext_UIWidgetBase::GetFunctionForAction(const UContext_ActionEntry* ActionEntry, FName& ExpectedFunctionName) const {
+	if (!IsValid(ActionEntry)) {
+		return nullptr;
+	}
+
+	FName DisplayFunctionName;
+	ActionEntry->GetPayloadFunctionNames(DisplayFunctionName, ExpectedFunctionName);
 	
-	// ~name stuff
-	// really funky, but it basically just copies how blueprint strings are named by default
-	const FString FunctionNameBase = FString::Printf(TEXT("GetPayload_%s"), *ActionName);
-	const FName DisplayFunctionName = FName(
-		FName::NameToDisplayString(
-			FunctionNameBase,
-			false));
-	ExpectedFunctionName = FName(FunctionNameBase);
-	// ~name stuff end
-		
-	UFunction* FunctionForAction = FindFunction(DisplayFunctionName);
-	return FunctionForAction;
+	return FContext_PayloadFunctionTable::FindPayloadFunction(GetClass(), ActionEntry);
+}
+
+void UContext_UIWidgetBase::InvalidateCachedContext() const {
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (!GameInstance) return;
+	
+	if (UContext_ActionSubsystem* Subsystem = GameInstance->GetSubsystem<UContext_ActionSubsystem>()) {
+		Subsystem->InvalidateContextCache(this);
+	}
 }
 
 #if WITH_EDITOR
@@ -146,12 +224,14 @@ EDataValidationResult UContext_UIWidgetBase::IsDataValid(FDataValidationContext&
 	//// Validate all context entries
 	TSet<UContext_ActionEntry*> EntriesToValidate = ContextEntries.Union(TSet(PrimaryContextEntryPriority));
 	for (const auto Entry : EntriesToValidate) {
-		const UContext_Action* BaseAction = Entry->Action.GetDefaultObject();
-
+		const UClass* ActionClass = Entry->LoadActionClass();
+		if (!ActionClass) continue;
+		
+		const UContext_Action* BaseAction = ActionClass->GetDefaultObject<UContext_Action>();
 		if (!IsValid(BaseAction->PayloadClass)) continue;
 		
 		FName ExpectedFunctionName;
-		const UFunction* Function = GetFunctionForAction(Entry->ActionName.ToString(), ExpectedFunctionName);
+		const UFunction* Function = GetFunctionForAction(Entry, ExpectedFunctionName);
 		
 		// PAYLOAD FUNCTION SHOULD EXIST FOR CONTEXT ENTRY
 		if (!IsValid(Function)) {
@@ -0,0 +1,168 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Validation/Context_AbilitySystemIndex.h"
+
+#include "AbilitySystemComponent.h"
+#include "Actions/Context_ActionSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+FContext_AbilitySystemIndex::~FContext_AbilitySystemIndex() {
+	Reset();
+}
+
+FContext_AbilitySystemIndex* FContext_AbilitySystemIndex::Find(const UObject* WorldContextObject) {
+	const UWorld* World = IsValid(WorldContextObject) ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UContext_ActionSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UContext_ActionSubsystem>() : nullptr;
+	
+	return Subsystem ? &Subsystem->GetAbilitySystemIndex() : nullptr;
+}
+
+uint32 FContext_AbilitySystemIndex::GetTagVersion(UAbilitySystemComponent* AbilitySystem) {
+	return Watch(AbilitySystem).TagVersion;
+}
+
+uint32 FContext_AbilitySystemIndex::GetAbilityVersion(UAbilitySystemComponent* AbilitySystem) {
+	FState& State = Watch(AbilitySystem);
+	RefreshAbilityVersion(State);
+	return State.AbilityVersion;
+}
+
+bool FContext_AbilitySystemIndex::HasAbilityWithTags(
+	UAbilitySystemComponent* AbilitySystem,
+	const FGameplayTagContainer& Tags) {
+
+	FState& State = Watch(AbilitySystem);
+	RefreshAbilityVersion(State);
+	RefreshAbilityIndex(State);
+
+	// Every ability has all of no tags
+	if (Tags.IsEmpty()) {
+		return State.AbilityTags.Num() > 0;
+	}
+
+	// Only abilities having the first tag can have all of them
+	const auto* Candidates = State.AbilitiesByTag.Find(Tags.GetByIndex(0));
+	if (!Candidates) {
+		return false;
+	}
+
+	for (const int32 AbilityIndex : *Candidates) {
+		if (State.AbilityTags[AbilityIndex].HasAllExact(Tags)) {
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+FContext_AbilitySystemIndex::FState& FContext_AbilitySystemIndex::Watch(UAbilitySystemComponent* AbilitySystem) {
+	check(IsInGameThread());
+	
+	const TObjectKey<UAbilitySystemComponent> Key(AbilitySystem);
+	if (FState* Existing = States.Find(Key)) {
+		return *Existing;
+	}
+
+	PruneIfNeeded();
+
+	FState& State = States.Add(Key);
+	State.AbilitySystem = AbilitySystem;
+	State.AbilitiesHash = HashAbilities(AbilitySystem);
+	State.AbilitiesCheckedFrame = GFrameCounter;
+
+	// Removed in Unwatch. If the ability system goes first, its delegates go with it and its state is pruned
+	State.TagChangedHandle = AbilitySystem->RegisterGenericGameplayTagEvent().AddLambda(
+		[this, Key](const FGameplayTag, int32) {
+			if (FState* Changed = States.Find(Key)) {
+				++Changed->TagVersion;
+			}
+		});
+	
+	// Fired on grants and removals, but also on every activation and end, so only flag the specs for a recheck
+	State.SpecDirtiedHandle = AbilitySystem->AbilitySpecDirtiedCallbacks.AddLambda(
+		[this, Key](const FGameplayAbilitySpec&) {
+			if (FState* Changed = States.Find(Key)) {
+				Changed->bAbilitiesMaybeChanged = true;
+			}
+		});
+
+	return State;
+}
+
+void FContext_AbilitySystemIndex::Reset() {
+	for (TPair<TObjectKey<UAbilitySystemComponent>, FState>& State : States) {
+		Unwatch(State.Value);
+	}
+	States.Empty();
+}
+
+void FContext_AbilitySystemIndex::Unwatch(FState& State) {
+	if (UAbilitySystemComponent* AbilitySystem = State.AbilitySystem.Get()) {
+		AbilitySystem->RegisterGenericGameplayTagEvent().Remove(State.TagChangedHandle);
+		AbilitySystem->AbilitySpecDirtiedCallbacks.Remove(State.SpecDirtiedHandle);
+	}
+	State.TagChangedHandle.Reset();
+	State.SpecDirtiedHandle.Reset();
+}
+
+void FContext_AbilitySystemIndex::RefreshAbilityVersion(FState& State) const {
+	const UAbilitySystemComponent* AbilitySystem = State.AbilitySystem.Get();
+	if (!AbilitySystem) return;
+
+	if (!State.bAbilitiesMaybeChanged && State.AbilitiesCheckedFrame == GFrameCounter) return;
+	State.bAbilitiesMaybeChanged = false;
+	State.AbilitiesCheckedFrame = GFrameCounter;
+
+	// Activations flag specs too, but leave the granted specs as they were
+	const uint32 AbilitiesHash = HashAbilities(AbilitySystem);
+	if (AbilitiesHash != State.AbilitiesHash) {
+		State.AbilitiesHash = AbilitiesHash;
+		++State.AbilityVersion;
+	}
+}
+
+uint32 FContext_AbilitySystemIndex::HashAbilities(const UAbilitySystemComponent* AbilitySystem) {
+	const TArray<FGameplayAbilitySpec>& Specs = AbilitySystem->GetActivatableAbilities();
+	
+	uint32 Hash = GetTypeHash(Specs.Num());
+	for (const FGameplayAbilitySpec& Spec : Specs) {
+		Hash = HashCombineFast(Hash, GetTypeHash(Spec.Handle));
+		Hash = HashCombineFast(Hash, PointerHash(Spec.Ability));
+	}
+	return Hash;
+}
+
+void FContext_AbilitySystemIndex::RefreshAbilityIndex(FState& State) const {
+	if (State.IndexedAbilityVersion == State.AbilityVersion) {
+		return;
+	}
+
+	State.AbilityTags.Reset();
+	State.AbilitiesByTag.Reset();
+	State.IndexedAbilityVersion = State.AbilityVersion;
+
+	const UAbilitySystemComponent* AbilitySystem = State.AbilitySystem.Get();
+	if (!AbilitySystem) return;
+	
+	for (const FGameplayAbilitySpec& Spec : AbilitySystem->GetActivatableAbilities()) {
+		if (!Spec.Ability) continue;
+
+		const int32 AbilityIndex = State.AbilityTags.Add(Spec.Ability->AbilityTags);
+		for (const FGameplayTag& Tag : Spec.Ability->AbilityTags) {
+			State.AbilitiesByTag.FindOrAdd(Tag).Add(AbilityIndex);
+		}
+	}
+}
+
+void FContext_AbilitySystemIndex::PruneIfNeeded() {
+	if (States.Num() < MaxStates) return;
+	
+	for (auto It = States.CreateIterator(); It; ++It) {
+		if (!It->Value.AbilitySystem.IsValid()) {
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -3,24 +3,27 @@
 
 #include "Validation/Context_ActionValidation.h"
 
+#include "Context_Settings.h"
+#include "Validation/Context_ValidationMemo.h"
 #include "Validation/Result/Context_ActionValidationResult.h"
 
 bool UContext_ActionValidation::RunValidation_Implementation(AActor* Caller, AActor* ContextOwner) {
+	// Only the evaluation is memoized, results below always run
 	bool bSuccess = false;
-	switch (ValidationSubject) {
-		case EActionValidation_Subject::Caller:
-			bSuccess = OnValidationStart(Caller);
-			break;
-		case EActionValidation_Subject::ContextOwner:
-			bSuccess = OnValidationStart(ContextOwner);
-			break;
-		case Both:
-			bSuccess = OnValidationStart(Caller) && OnValidationStart(ContextOwner);
-			break;
+	FContext_ValidationMemo* Memo = GetDefault<UContext_Settings>()->bMemoizeValidations ?
+		FContext_ValidationMemo::Find(Caller, ContextOwner) :
+		nullptr;
+	
+	if (!Memo || !Memo->Find(this, Caller, ContextOwner, bSuccess)) {
+		bSuccess = EvaluateSubjects(Caller, ContextOwner);
+		
+		if (Memo) {
+			Memo->Store(this, Caller, ContextOwner, bSuccess);
+		}
 	}
 	
 	// Execute desired result actions (Show errors to player, give items, whatever)
-	TArray<UContext_ActionValidationResult*> ResultToExecute = bSuccess ? OnSuccess : OnFail;
+	const TArray<UContext_ActionValidationResult*>& ResultToExecute = bSuccess ? OnSuccess : OnFail;
 	for (const auto ResultAction : ResultToExecute) {
 		ResultAction->RunResultAction(Caller, ContextOwner);
 	}
@@ -31,6 +34,33 @@ bool UContext_ActionValidation::RunValidation_Implementation(AActor* Caller, AAc
 	
 }
 
+bool UContext_ActionValidation::EvaluateSubjects(AActor* Caller, AActor* ContextOwner) {
+	switch (ValidationSubject) {
+		case EActionValidation_Subject::Caller:
+			return OnValidationStart(Caller);
+		case EActionValidation_Subject::ContextOwner:
+			return OnValidationStart(ContextOwner);
+		case Both:
+			return OnValidationStart(Caller) && OnValidationStart(ContextOwner);
+	}
+	return false;
+}
+
 bool UContext_ActionValidation::OnValidationStart_Implementation(AActor* Entity) {
 	return true;
 }
+
+void UContext_ActionValidation::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	for (const UContext_ActionValidationResult* Result : OnSuccess) {
+		if (IsValid(Result)) Result->GetStreamedAssets(OutAssets);
+	}
+	for (const UContext_ActionValidationResult* Result : OnFail) {
+		if (IsValid(Result)) Result->GetStreamedAssets(OutAssets);
+	}
+}
+
+EContext_ValidationCost UContext_ActionValidation::GetValidationCost() const {
+	return GetClass()->HasAnyClassFlags(CLASS_Native) ?
+		EContext_ValidationCost::Native :
+		EContext_ValidationCost::Blueprint;
+}
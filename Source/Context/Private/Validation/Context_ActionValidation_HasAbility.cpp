@@ -6,6 +6,11 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 #include "Context_SystemComponent.h"
+#include "Validation/Context_AbilitySystemIndex.h"
+
+UContext_ActionValidation_HasAbility::UContext_ActionValidation_HasAbility() {
+	ValidationDependency = EContext_ValidationDependency::Abilities;
+}
 
 bool UContext_ActionValidation_HasAbility::OnValidationStart_Implementation(AActor* Entity) {
 	UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Entity);
@@ -14,8 +19,13 @@ bool UContext_ActionValidation_HasAbility::OnValidationStart_Implementation(AAct
 		return false;
 	}
 
-	// Find how many (If any) of the ability we have.
-	TArray<FGameplayAbilitySpecHandle> OutAbilityHandles;
-	ASC->FindAllAbilitiesWithTags(OutAbilityHandles, RequiredAbilityTag);
-	return OutAbilityHandles.Num() != 0;
+	// Stops at the first granted ability with the tags
+	if (FContext_AbilitySystemIndex* Index = FContext_AbilitySystemIndex::Find(ASC)) {
+		return Index->HasAbilityWithTags(ASC, RequiredAbilityTag);
+	}
+
+	// Outside of a game instance, there's no index to ask
+	TArray<FGameplayAbilitySpecHandle> AbilityHandles;
+	ASC->FindAllAbilitiesWithTags(AbilityHandles, RequiredAbilityTag, true);
+	return AbilityHandles.Num() > 0;
 }
@@ -6,6 +6,10 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemGlobals.h"
 
+UContext_ActionValidation_HasTag::UContext_ActionValidation_HasTag() {
+	ValidationDependency = EContext_ValidationDependency::Tags;
+}
+
 bool UContext_ActionValidation_HasTag::OnValidationStart_Implementation(AActor* Entity) {
 	UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Entity);
 	if (IsValid(ASC)) {
@@ -0,0 +1,124 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Validation/Context_ValidationMemo.h"
+
+#include "AbilitySystemGlobals.h"
+#include "Actions/Context_ActionSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Validation/Context_AbilitySystemIndex.h"
+#include "Validation/Context_ActionValidation.h"
+
+FContext_ValidationMemo* FContext_ValidationMemo::Find(const AActor* Caller, const AActor* ContextOwner) {
+	const AActor* Subject = IsValid(Caller) ? Caller : ContextOwner;
+	const UWorld* World = IsValid(Subject) ? Subject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	UContext_ActionSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UContext_ActionSubsystem>() : nullptr;
+	
+	return Subsystem ? &Subsystem->GetValidationMemo() : nullptr;
+}
+
+bool FContext_ValidationMemo::Find(
+	const UContext_ActionValidation* Validation,
+	const AActor* Caller,
+	const AActor* ContextOwner,
+	bool& bOutResult) {
+
+	check(IsInGameThread());
+	
+	const EContext_ValidationDependency Dependency = Validation->GetValidationDependency();
+	if (Dependency == EContext_ValidationDependency::Always) {
+		return false;
+	}
+
+	const FResult* Result = Results.Find(FKey(Validation, Caller, ContextOwner));
+	if (!Result) {
+		++Misses;
+		return false;
+	}
+
+	bool bValid = Result->Frame == GFrameCounter;
+	if (Dependency != EContext_ValidationDependency::Frame) {
+		uint32 CallerVersion = 0, OwnerVersion = 0;
+		const bool bTracked = GetStateVersion(Caller, Dependency, CallerVersion) & GetStateVersion(ContextOwner, Dependency, OwnerVersion);
+		
+		// Untracked subjects fall back to frame lifetime
+		if (bTracked) {
+			bValid = Result->CallerVersion == CallerVersion && Result->OwnerVersion == OwnerVersion;
+		}
+	}
+
+	if (!bValid) {
+		++Misses;
+		return false;
+	}
+
+	++Hits;
+	bOutResult = Result->bResult;
+	return true;
+}
+
+void FContext_ValidationMemo::Store(
+	const UContext_ActionValidation* Validation,
+	const AActor* Caller,
+	const AActor* ContextOwner,
+	const bool bResult) {
+
+	check(IsInGameThread());
+	
+	const EContext_ValidationDependency Dependency = Validation->GetValidationDependency();
+	if (Dependency == EContext_ValidationDependency::Always) {
+		return;
+	}
+
+	PruneIfNeeded();
+
+	FResult& Result = Results.FindOrAdd(FKey(Validation, Caller, ContextOwner));
+	Result.bResult = bResult;
+	Result.Frame = GFrameCounter;
+	Result.CallerVersion = 0;
+	Result.OwnerVersion = 0;
+	
+	if (Dependency != EContext_ValidationDependency::Frame) {
+		GetStateVersion(Caller, Dependency, Result.CallerVersion);
+		GetStateVersion(ContextOwner, Dependency, Result.OwnerVersion);
+	}
+}
+
+void FContext_ValidationMemo::Reset() {
+	Results.Empty();
+}
+
+void FContext_ValidationMemo::ResetStats() {
+	Hits = 0;
+	Misses = 0;
+}
+
+bool FContext_ValidationMemo::GetStateVersion(
+	const AActor* Actor,
+	const EContext_ValidationDependency Dependency,
+	uint32& OutVersion) {
+
+	OutVersion = 0;
+	if (!IsValid(Actor)) {
+		return true;
+	}
+	
+	UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor);
+	if (!IsValid(AbilitySystem)) {
+		return false;
+	}
+
+	OutVersion = Dependency == EContext_ValidationDependency::Tags ?
+		AbilitySystemIndex.GetTagVersion(AbilitySystem) :
+		AbilitySystemIndex.GetAbilityVersion(AbilitySystem);
+	return true;
+}
+
+void FContext_ValidationMemo::PruneIfNeeded() {
+	// Results are cheap to rebuild, so they're dropped all at once
+	if (Results.Num() >= MaxResults) {
+		Results.Reset();
+	}
+}
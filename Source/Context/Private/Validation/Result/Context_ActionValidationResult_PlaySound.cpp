@@ -8,13 +8,20 @@
 #include "Sound/SoundCue.h"
 
 void UContext_ActionValidationResult_PlaySound::OnResultActionStart_Implementation(AActor* Entity) {
-	UGameplayStatics::PlaySound2D(Entity, SoundCueToPlay);
+	// Normally streamed in with the entry, see UContext_ActionEntry::GetStreamedAssets
+	UGameplayStatics::PlaySound2D(Entity, SoundCueToPlay.LoadSynchronous());
+}
+
+void UContext_ActionValidationResult_PlaySound::GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const {
+	if (!SoundCueToPlay.IsNull()) {
+		OutAssets.Add(SoundCueToPlay.ToSoftObjectPath());
+	}
 }
 
 #if WITH_EDITOR
 EDataValidationResult UContext_ActionValidationResult_PlaySound::IsDataValid(FDataValidationContext& Context) const {
 
-	if (!IsValid(SoundCueToPlay)) {
+	if (SoundCueToPlay.IsNull()) {
 		Context.AddError(FText::FromString("Action Result PlaySound must be provided a sound cue"));
 	}
 	
@@ -11,6 +11,43 @@
 
 class UContext_ActionPayloadBase;
 class IContext_Holder;
+
+/**
+ * How the action subsystem gets an action object to execute
+ */
+UENUM(BlueprintType)
+enum class EContext_ActionExecutionMode : uint8 {
+	/** A new action object is created for every execution */
+	Instanced,
+	/**
+	 * Action objects are reused from a pool. The action must be done with its state once ExecuteContextAction returns,
+	 * and should reset anything it changed in OnReleasedToPool.
+	 */
+	Pooled,
+	/** The class default object runs ExecuteStatelessContextAction, and per execution state is passed in */
+	Stateless,
+};
+
+/**
+ * Per execution state passed to stateless actions
+ */
+USTRUCT(BlueprintType)
+struct FContext_ActionExecutionContext {
+	GENERATED_BODY()
+
+	/** The actor executing the action */
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Action")
+	AActor* InstigatorActor = nullptr;
+
+	/** The holder the action was executed on */
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Action")
+	UObject* ContextHolder = nullptr;
+
+	/** The world the action was executed in. The class default object running a stateless action has none of its own */
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Action")
+	UWorld* World = nullptr;
+};
+
 /**
  * An action that is executed by a context menu or context execution of some kind
  * This action should be fairly self contained
@@ -27,6 +64,13 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	AActor* InstigatorActor;
 
+	/**
+	 * How this action is executed. Pooled and Stateless avoid creating an object for every execution, which matters for
+	 * actions executed very often (auto-loot, crafting queues).
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Action|Execution")
+	EContext_ActionExecutionMode ExecutionMode = EContext_ActionExecutionMode::Instanced;
+
 	/**
 	 * The logic that gets called when this context action is executed 
 	 * @param ContextHolder  The object that this action interacts with, or fetches data from
@@ -36,38 +80,81 @@ public:
 	UFUNCTION(BlueprintNativeEvent)
 	bool ExecuteContextAction(UObject* ContextHolder, const UContext_ActionPayloadBase* Payload);
 	virtual bool ExecuteContextAction_Implementation(UObject* ContextHolder, const UContext_ActionPayloadBase* Payload) {
-		// is no payload is set, we expect a nullptr
-		if (!IsValid(PayloadClass) && Payload != nullptr) {
-			return false;
-		}
-
-		// if our payload is different than the desired payload, fail
-		if (Payload->GetClass() != PayloadClass) {
-			UE_LOG(LogContextSystem, Error, TEXT("Incorrect payload type passed to %s. Expected %s but got %s"),
-				*GetName(),
-				*PayloadClass->GetName(),
-				*Payload->GetClass()->GetName())
-			return false;
-		}
-		
-		return true;
+		return IsPayloadValid(Payload);
 	}
 
+	/**
+	 * The logic that gets called when this action is executed in Stateless mode. Runs on the class default object,
+	 * so it must not modify the action. GetWorld returns null on it, use the world of the execution context instead,
+	 * or the helpers taking one.
+	 * @param ExecutionContext Per execution state, such as the instigator
+	 * @param ContextHolder The object that this action interacts with, or fetches data from
+	 * @param Payload The payload to pass the action, if any
+	 * @return 
+	 */
+	UFUNCTION(BlueprintNativeEvent)
+	bool ExecuteStatelessContextAction(
+		const FContext_ActionExecutionContext& ExecutionContext,
+		UObject* ContextHolder,
+		const UContext_ActionPayloadBase* Payload) const;
+	virtual bool ExecuteStatelessContextAction_Implementation(
+		const FContext_ActionExecutionContext& ExecutionContext,
+		UObject* ContextHolder,
+		const UContext_ActionPayloadBase* Payload) const {
+		return IsPayloadValid(Payload);
+	}
+
+	/**
+	 * Called when a pooled action is taken from the pool, before it's executed
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Context|Action|Execution")
+	void OnAcquiredFromPool();
+	virtual void OnAcquiredFromPool_Implementation() {}
+
+	/**
+	 * Called when a pooled action is returned to the pool. Reset any state set during execution here.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Context|Action|Execution")
+	void OnReleasedToPool();
+	virtual void OnReleasedToPool_Implementation() {
+		InstigatorActor = nullptr;
+	}
+
+	/**
+	 * Checks the payload matches the payload class this action expects
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Action|Payload")
+	bool IsPayloadValid(const UContext_ActionPayloadBase* Payload) const;
+
 	UFUNCTION(BlueprintCallable, Category = "Context")
 	AActor* GetInstigator();
 	
 	/**
 	 * Gets and returns the HUD belonging to the local player actor
+	 * Returns null if the action has no world, such as when running stateless. See GetLocalPlayerHUDForContext
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Context|Action|Helper")
 	AHUD* GetLocalPlayerHUD() const;
 
 	/**
 	 * Fetches the player controller owned by the local player
+	 * Returns null if the action has no world, such as when running stateless. See GetLocalPlayerControllerForContext
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Context|Action|Helper")
 	APlayerController* GetLocalPlayerControllerForAction() const;
 
+	/**
+	 * Gets the HUD belonging to the local player, in the world of a stateless execution
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Action|Helper")
+	static AHUD* GetLocalPlayerHUDForContext(const FContext_ActionExecutionContext& ExecutionContext);
+
+	/**
+	 * Fetches the player controller owned by the local player, in the world of a stateless execution
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Action|Helper")
+	static APlayerController* GetLocalPlayerControllerForContext(const FContext_ActionExecutionContext& ExecutionContext);
+
 	/**
 	 * Helper for exposing GetWorld, which would not otherwise be usable 
 	 */
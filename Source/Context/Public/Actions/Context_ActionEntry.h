@@ -9,6 +9,21 @@
 
 class UContext_ActionValidation;
 class UContext_Action;
+class UContext_ActionPayloadBase;
+
+/**
+ * An entry's validations, flattened and ordered for evaluation
+ */
+struct FContext_ValidationPlan {
+	/** Validations that can fail the entry, cheapest first */
+	TArray<UContext_ActionValidation*> Blocking;
+	
+	/** AllowFail validations. They never fail the entry, so they only run once every blocking validation passed */
+	TArray<UContext_ActionValidation*> NonBlocking;
+	
+	bool bCompiled = false;
+};
+
 /**
  * An action entry is a container for an action used anywhere that it needs to be represented.
  * Actions do not have names, descriptions, or anything else that can be used by UI or example
@@ -16,9 +31,15 @@ class UContext_Action;
  * This allows you to have multiple entries that use the same action with different settings and names.
  *
  * This is what most systems interact with and use to get the action.
+ *
+ * Entries only hold what menus need to display them. Everything used to execute them (the action class, and assets used
+ * by validation results) is soft referenced, and the action subsystem streams those paths in through the streamable
+ * manager when the entry is first shown or hovered. See GetStreamedAssets and UContext_ActionSubsystem::StreamEntryAssets
+ * The soft references are also tagged with the "Action" asset bundle, for projects loading entries through the asset
+ * manager themselves, but nothing in the plugin loads by bundle.
  */
 UCLASS(BlueprintType)
-class CONTEXT_API UContext_ActionEntry : public UDataAsset {
+class CONTEXT_API UContext_ActionEntry : public UPrimaryDataAsset {
 	GENERATED_BODY()
 	
 public:
@@ -63,13 +84,88 @@ public:
 	/**
 	 * The action that should be executed when the menu entry is chosen
 	 */
-	UPROPERTY(EditDefaultsOnly)
-	TSubclassOf<UContext_Action> Action;
+	UPROPERTY(EditDefaultsOnly, meta = (AssetBundles = "Action"))
+	TSoftClassPtr<UContext_Action> Action;
+
+	/**
+	 * Gets the action class, if it's loaded
+	 */
+	UClass* GetActionClass() const { return Action.Get(); }
+
+	/**
+	 * Gets the action class, loading it right away if it wasn't streamed in yet
+	 */
+	UClass* LoadActionClass() const;
+
+	/**
+	 * Payload class of Action, recorded when the entry is edited or saved so payloads can be looked up by type
+	 * without loading the action. See GetActionPayloadClassPath
+	 */
+	UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = "Payload")
+	TSoftClassPtr<UContext_ActionPayloadBase> ActionPayloadClass;
+
+	/** True once ActionPayloadClass was recorded, null is a valid recording for actions without a payload */
+	UPROPERTY()
+	bool bActionPayloadClassRecorded = false;
+
+	/**
+	 * Gets the payload class of the action without loading it. Uses the action if it's loaded, ActionPayloadClass if not.
+	 * @return Null if the action has no payload class, or isn't loaded and none was recorded
+	 */
+	FSoftObjectPath GetActionPayloadClassPath() const;
+
+	/**
+	 * False if the action isn't loaded and no payload class was recorded (entries saved before it was), so
+	 * GetActionPayloadClassPath can't tell yet whether the action has a payload class
+	 */
+	bool IsActionPayloadClassKnown() const;
+
+	/**
+	 * Gets the soft paths needed to execute the entry: the action class, and assets used by validation results
+	 * @param OutAssets Array to add the assets to
+	 */
+	void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const;
+
+	/**
+	 * Stable identifier used to find this entry's payload function on holders (GetPayload_<PayloadId>).
+	 * If empty, the source string of ActionName is used, so localization never changes which function is called.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Payload")
+	FName PayloadId;
+
+	/**
+	 * Gets the names a holder's payload function for this entry may have, built once per entry
+	 * @param OutDisplayName Display-formatted name, the way Blueprint names functions by default ("Get Payload Open")
+	 * @param OutExpectedName Raw name ("GetPayload_Open")
+	 */
+	void GetPayloadFunctionNames(FName& OutDisplayName, FName& OutExpectedName) const;
 	
-	/// Runs validations on the context action, and returns it if it's valid. 
+	/// Runs validations on the context action, and returns it if it's valid.
+	/// Validations run cheapest first and stop at the first failure, see FContext_ValidationPlan
 	/// @param Caller 
 	/// @param ContextOwner 
 	/// @return 
 	UFUNCTION(BlueprintCallable, Category="Context")
 	bool RunActionValidations(AActor* Caller, AActor* ContextOwner) const;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
+private:
+#if WITH_EDITOR
+	/// Records the payload class of the action in ActionPayloadClass, loading the action if needed
+	void RecordActionPayloadClass();
+#endif
+
+	/// Builds the validation plan from Validations
+	void CompileValidationPlan() const;
+	
+	/// Validations ordered for evaluation, compiled on first use
+	mutable FContext_ValidationPlan ValidationPlan;
+	
+	/// Payload function names, resolved on first use
+	mutable FName PayloadFunctionDisplayName;
+	mutable FName PayloadFunctionExpectedName;
 };
@@ -3,7 +3,12 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Context_TagIndex.h"
+#include "Spatial/Context_HolderSpatialHash.h"
+#include "Validation/Context_AbilitySystemIndex.h"
+#include "Validation/Context_ValidationMemo.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "Context_ActionSubsystem.generated.h"
 
 class UContext_ActionPayloadBase;
@@ -12,6 +17,9 @@ class UContext_Menu;
 class UContext_ActionEntry;
 class UContext_Action;
 class IContext_Holder;
+class APlayerController;
+struct FGameplayTagContainer;
+struct FStreamableHandle;
 
 DEFINE_LOG_CATEGORY_STATIC(LogContextSubsystem, Log, All);
 
@@ -43,6 +51,132 @@ struct FContextEntryPackage {
 	TSet<UContext_ActionEntry*> ContextEntries;
 };
 
+/**
+ * Idle instances of a single pooled action class
+ */
+USTRUCT()
+struct FContext_ActionPool {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<UContext_Action*> IdleActions;
+};
+
+/**
+ * Versions of everything that affects the entries of a holder: the holder itself, and every giver above it, nearest first.
+ * Kept side by side rather than combined, so comparing two of them can never mistake a change for a match.
+ */
+struct FContext_TreeVersion {
+	uint32 HolderVersion = 0;
+	TArray<uint32, TInlineAllocator<16>> GiverVersions;
+
+	/** False if the holder or any giver above it is unversioned, meaning nothing resolved for it can be reused */
+	bool IsVersioned() const { return HolderVersion != 0; }
+
+	void Reset() {
+		HolderVersion = 0;
+		GiverVersions.Reset();
+	}
+
+	bool operator==(const FContext_TreeVersion& Other) const {
+		return HolderVersion == Other.HolderVersion && GiverVersions == Other.GiverVersions;
+	}
+	bool operator!=(const FContext_TreeVersion& Other) const { return !(*this == Other); }
+};
+
+/**
+ * Resolved valid entries of a single holder, along with the versions they were resolved against.
+ * Entries are owned by the holder or its givers, which outlive the cache entry.
+ */
+struct FContext_ValidEntryCache {
+	FContext_TreeVersion TreeVersion;
+	uint32 GiverEpoch = 0;
+	uint32 TreeEpoch = 0;
+	TArray<UContext_ActionEntry*> ValidEntries;
+};
+
+/**
+ * A menu computed ahead of a click for a hovered holder, along with what it was computed against.
+ * Entries are owned by the holder or its givers, which outlive it as long as the holder is valid.
+ */
+struct FContext_PrecomputedMenu {
+	TWeakObjectPtr<UObject> ContextHolder;
+	TArray<UContext_ActionEntry*> DefaultEntries;
+	TArray<FContextEntryPackage> Packages;
+	UContext_ActionEntry* PrimaryEntry = nullptr;
+	FContext_TreeVersion TreeVersion;
+	uint32 GiverEpoch = 0;
+	uint32 TreeEpoch = 0;
+	uint64 Frame = 0;
+
+	bool HasDefaultEntries(const TConstArrayView<UContext_ActionEntry*> Entries) const {
+		if (DefaultEntries.Num() != Entries.Num()) return false;
+		
+		for (int32 Index = 0; Index < Entries.Num(); Index++) {
+			if (DefaultEntries[Index] != Entries[Index]) return false;
+		}
+		return true;
+	}
+};
+
+/**
+ * A payload requested from a holder, along with what it was requested against
+ */
+struct FContext_CachedPayload {
+	/** Kept alive by UContext_ActionSubsystem::AddReferencedObjects */
+	const UContext_ActionPayloadBase* Payload = nullptr;
+	uint32 HolderVersion = 0;
+	uint64 Frame = 0;
+};
+
+/**
+ * Cached payloads of a single holder, per entry
+ */
+using FContext_HolderPayloads = TMap<TObjectKey<UContext_ActionEntry>, FContext_CachedPayload>;
+
+/**
+ * A single giver found above a holder, and how far above the holder it is
+ */
+struct FContext_GiverLink {
+	TWeakObjectPtr<UObject> Giver;
+	int32 Depth = 0;
+};
+
+/**
+ * Givers copied out of a chain, so giver calls can safely re-enter the subsystem while we iterate
+ */
+using FContext_GiverLinkArray = TArray<FContext_GiverLink, TInlineAllocator<16>>;
+
+/**
+ * Flattened list of every giver above a holder, in the order GetNextObjectInTree would visit them.
+ * Covers both the component/actor outer chain and the widget parent chain.
+ */
+struct FContext_GiverChain {
+	uint32 TreeEpoch = 0;
+
+	// Depth the chain was walked to. Only meaningful if the walk didn't reach the root of the tree
+	int32 BuiltDepth = 0;
+	bool bReachedRoot = false;
+
+	TArray<FContext_GiverLink> Givers;
+
+	bool CoversDepth(const int32 MaxDepth) const { return bReachedRoot || BuiltDepth >= MaxDepth; }
+};
+
+/**
+ * Entries contributed by a single giver, cached until the giver's version or the giver epoch changes
+ */
+struct FContext_GiverEntries {
+	uint32 GiverVersion = 0;
+	
+	bool bEntriesResolved = false;
+	TSet<UContext_ActionEntry*> Entries;
+
+	// Primary entry is only resolved on demand
+	bool bPrimaryResolved = false;
+	UContext_ActionEntry* PrimaryEntry = nullptr;
+};
+
 /**
  * 
  */
@@ -53,15 +187,115 @@ class CONTEXT_API UContext_ActionSubsystem : public UGameInstanceSubsystem {
 	UPROPERTY()
 	UContext_Menu* ContextMenu;
 
+	/**
+	 * Background load of UContext_Settings::ContextMenuClass, started when the game instance starts
+	 */
+	TSharedPtr<FStreamableHandle> ContextMenuLoadHandle;
+
+	/**
+	 * Player the context menu is shown to, handed to menus built after it was given
+	 */
+	TWeakObjectPtr<APlayerController> ContextMenuOwner;
+
 	UPROPERTY(meta = (Bitmask, BitmaskEnum=EContext_EnabledContextSource))
 	EContext_ContextSource EnabledSources;
 
+	/**
+	 * Per holder cache of valid entries, keyed on the holder. See IContext_Holder::GetContextVersion
+	 */
+	mutable TMap<TObjectKey<UObject>, FContext_ValidEntryCache> ValidEntryCache;
+
+	/**
+	 * Bumped whenever any giver's contribution changes. Invalidates every cached holder, since any holder may be
+	 * below the giver that changed.
+	 */
+	uint32 GiverEpoch = 1;
+
+	/**
+	 * Ancestor givers of each versioned holder
+	 */
+	mutable TMap<TObjectKey<UObject>, FContext_GiverChain> GiverChainCache;
+
+	/**
+	 * Entries contributed by each versioned giver, shared by every holder below it
+	 */
+	mutable TMap<TObjectKey<UObject>, FContext_GiverEntries> GiverEntriesCache;
+
+	/**
+	 * Last entries of an unversioned giver. Never reused, only keeps them alive for the caller of GetGiverEntries
+	 */
+	mutable TSet<UContext_ActionEntry*> UnversionedGiverEntries;
+
+	/**
+	 * Bumped whenever the tree above any holder may have changed shape (attach/detach, re-parenting, re-outering)
+	 */
+	uint32 TreeEpoch = 1;
+
+	/**
+	 * Entry tags compiled into bitmasks, used to filter all of a holder's entries at once
+	 */
+	mutable FContext_TagIndex TagIndex;
+
+	/**
+	 * Ability systems looked at by validations in this game instance. See FContext_AbilitySystemIndex
+	 */
+	FContext_AbilitySystemIndex AbilitySystemIndex;
+	
+	/**
+	 * Validation results of this game instance. See FContext_ValidationMemo
+	 */
+	FContext_ValidationMemo ValidationMemo { AbilitySystemIndex };
+
+	/**
+	 * How far up the tree entries are aggregated from when resolving a holder. Matches the tree functions' default
+	 */
+	static constexpr int32 DefaultTreeDepth = 10;
+
+	/**
+	 * Below this many holders, parallel evaluation runs on the calling thread as task overhead would dominate
+	 */
+	static constexpr int32 ParallelEvaluationMinHolders = 32;
+
+	/**
+	 * Every holder registered for spatial queries, positioned where its owner is
+	 */
+	FContext_HolderSpatialHash HolderSpatialIndex;
+
+	/**
+	 * Idle action instances of every pooled action class
+	 */
+	UPROPERTY()
+	TMap<TSubclassOf<UContext_Action>, FContext_ActionPool> ActionPools;
+
+	/**
+	 * When input last asked for a menu, for measuring how long it takes to show. 0 if no menu is pending
+	 */
+	uint64 MenuOpenRequestCycles = 0;
+
+	/**
+	 * Streaming requests for the soft paths of entries, see UContext_ActionEntry::GetStreamedAssets. Kept so streamed assets stay loaded, see StreamEntryAssets
+	 */
+	TMap<TObjectKey<UContext_ActionEntry>, TSharedPtr<FStreamableHandle>> EntryAssetHandles;
+	
+	/**
+	 * Payloads requested from each holder. Only used if UContext_Settings::PayloadCacheMode is enabled
+	 */
+	TMap<TObjectKey<UObject>, FContext_HolderPayloads> PayloadCache;
+
+	/**
+	 * Menu of the holder last hovered long enough, see PrecomputeContextMenu
+	 */
+	FContext_PrecomputedMenu PrecomputedMenu;
 	
 public:
 
 	UPROPERTY(BlueprintReadWrite)
 	TWeakObjectPtr<UContext_UIWidgetBase> UIContextElement;
 
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+	
 	////////
 	/// ~CONTEXT SOURCE
 	
@@ -96,6 +330,24 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|UI")
 	void SetContextMenuInstance(UContext_Menu* ContextMenuInstance);
+
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|UI")
+	UContext_Menu* GetContextMenuInstance() const { return ContextMenu; }
+
+	/**
+	 * Builds the context menu offscreen, with UContext_Settings::PrewarmedEntryButtons buttons, and uses it from now on
+	 * in place of any other menu. Does nothing if a menu of exactly that class is already in use.
+	 * @param MenuClass The menu to build
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|UI")
+	void PrewarmContextMenu(TSubclassOf<UContext_Menu> MenuClass);
+
+	/**
+	 * Gives the context menu to a player, adding it to their viewport. Menus built later are given to them too.
+	 * @param PlayerController The player the menu is shown to
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|UI")
+	void SetContextMenuOwner(APlayerController* PlayerController);
 	
 	/**
 	 * Shows the context menu UI on the screen
@@ -117,6 +369,79 @@ public:
 		FVector2D ScreenPosition,
 		const TArray<FContextEntryPackage>& ContextEntries);
 	
+	/**
+	 * Marks that input asked for a menu. The menu measures how long it took to show up from this point.
+	 * See STAT_Context_InputToMenuVisibleMs
+	 */
+	void MarkMenuOpenRequested() { MenuOpenRequestCycles = FPlatformTime::Cycles64(); }
+
+	/**
+	 * Gets when input last asked for a menu, and clears it
+	 * @return Cycles at which the menu was requested, or 0 if none is pending
+	 */
+	uint64 ConsumeMenuOpenRequest() {
+		const uint64 RequestCycles = MenuOpenRequestCycles;
+		MenuOpenRequestCycles = 0;
+		return RequestCycles;
+	}
+	
+	/**
+	 * Streams in what an entry needs to be executed (see UContext_ActionEntry::GetStreamedAssets), if it isn't loaded or loading already.
+	 * Called when entries are shown or hovered, so they're ready by the time they are executed.
+	 * @param Entry The entry to stream in
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Streaming")
+	void StreamEntryAssets(const UContext_ActionEntry* Entry);
+
+	/**
+	 * Streams in what every entry in the packages needs to be executed
+	 */
+	void StreamEntryAssetsForPackages(const TArray<FContextEntryPackage>& ContextEntries);
+
+	/**
+	 * Lets go of every streamed entry asset, so unused ones can be unloaded. Entries stream in again when next shown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Streaming")
+	void ReleaseEntryAssets();
+
+	////////
+	/// ~SPECULATIVE MENUS
+
+	/**
+	 * Computes the menu and primary entry of a holder ahead of time, usually because the cursor rests on it.
+	 * A click on the same holder then shows this menu instead of computing it, as long as nothing changed since.
+	 * Payloads aren't requested, as payload getters may have side effects and hovering shouldn't trigger them.
+	 * @param ContextObject Holder, or object with a holder, to compute the menu for
+	 * @param DefaultEntries Entries added to the menu of every holder
+	 */
+	void PrecomputeContextMenu(UObject* ContextObject, TConstArrayView<UContext_ActionEntry*> DefaultEntries);
+
+	/**
+	 * Gets the precomputed menu of a holder, if it's still valid
+	 * @param ContextObject Holder, or object with a holder, to get the menu for
+	 * @param DefaultEntries Entries added to the menu of every holder. Must match the precomputed ones
+	 * @param OutPackages The precomputed menu
+	 * @return False if there is no valid precomputed menu for this holder
+	 */
+	bool FindPrecomputedContextMenu(
+		const UObject* ContextObject,
+		TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+		TArray<FContextEntryPackage>& OutPackages) const;
+
+	/**
+	 * Gets the precomputed primary entry of a holder, if it's still valid
+	 * @param ContextObject Holder, or object with a holder, to get the primary entry for
+	 * @param OutPrimaryEntry The precomputed primary entry, which may be null if the holder has none
+	 * @return False if there is no valid precomputed menu for this holder
+	 */
+	bool FindPrecomputedPrimaryEntry(const UObject* ContextObject, UContext_ActionEntry*& OutPrimaryEntry) const;
+
+	/**
+	 * Drops the precomputed menu
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void ClearPrecomputedContextMenu();
+	
 	/**
 	 * Hides the context menu, if it is currently visible
 	 */
@@ -141,6 +466,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Action")
 	bool ExecuteAction(TScriptInterface<IContext_Holder> ContextObject, const UContext_ActionEntry* Action, AActor* InstigatorActor);
 
+	/**
+	 * Gets the payload a holder provides for an entry, reusing the cached payload if the payload cache is enabled
+	 * @param ContextObject The holder providing the payload
+	 * @param Entry The entry the payload is for
+	 * @return Payload, which may be null
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Action")
+	const UContext_ActionPayloadBase* GetPayloadForEntry(TScriptInterface<IContext_Holder> ContextObject, const UContext_ActionEntry* Entry);
+
+	/**
+	 * Resolves the payloads of every entry in the packages in one pass, so executing any of them doesn't have to.
+	 * Within a holder, entries whose payload comes from the same function share a single payload, see
+	 * IContext_Holder::GetPayloadFunction. Every other entry requests its own.
+	 * Does nothing if the payload cache is disabled.
+	 * @param ContextEntries Packages shown in a menu
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Action")
+	void ResolvePayloadsForPackages(const TArray<FContextEntryPackage>& ContextEntries);
+
 	/**
 	 * Execute the provided action 
 	 * @param ContextObject 
@@ -167,8 +511,194 @@ public:
 	UFUNCTION(BlueprintCallable)
 	TSet<UContext_ActionEntry*> GetValidContextEntriesForObject(const UObject* ContextObject) const;
 
+	/**
+	 * Gets all valid context entries for the provided object into a caller provided buffer.
+	 * Once the holder's entries are cached, this does not allocate as long as OutEntries has enough capacity,
+	 * which makes it the preferred way to poll holders.
+	 * @param ContextObject The object to get entries for
+	 * @param OutEntries Reset, then filled with the valid entries
+	 */
+	void CollectValidContextEntries(const UObject* ContextObject, TArray<UContext_ActionEntry*>& OutEntries) const;
+
 	UFUNCTION(BlueprintCallable)
 	UContext_ActionEntry* GetPrimaryContextEntryForObject(const UObject* ContextObject) const;
+
+	/**
+	 * Checks if a tag, or any of its parents, is used by any entry evaluated so far.
+	 * Holders use it to ignore tag changes that can't change which entries are valid.
+	 */
+	bool IsGameplayTagReferenced(const FGameplayTag& Tag) const { return TagIndex.IsReferenced(Tag); }
+
+	/**
+	 * Changes whenever entries start referencing new tags. Holders ignoring tag changes must refresh their tags then.
+	 */
+	uint32 GetReferencedTagsVersion() const { return TagIndex.GetReferencedTagsVersion(); }
+
+	/**
+	 * Builds the entry packages of many objects in one pass, such as every actor hit by a trace.
+	 * Holders are only resolved once, and default entries are shared between every package.
+	 * @param ContextObjects Objects to build packages for. Objects without a holder are skipped.
+	 * @param DefaultEntries Entries added to every package, without validation
+	 * @param OutPackages One package per unique holder found, in the order of ContextObjects
+	 */
+	void GetContextEntryPackagesForObjects(
+		TConstArrayView<UObject*> ContextObjects,
+		TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+		TArray<FContextEntryPackage>& OutPackages) const;
+
+	/**
+	 * Same as GetContextEntryPackagesForObjects, but filters holders in parallel. Meant for wide scans (minimap
+	 * icons, AI, "what can I interact with") over hundreds or thousands of holders.
+	 * Holder tags and entries are snapshotted into plain data on the game thread, filtered on task threads, then
+	 * merged back on the game thread in the order of ContextObjects. Must be called from the game thread.
+	 * @param ContextObjects Objects to build packages for. Objects without a holder are skipped.
+	 * @param DefaultEntries Entries added to every package, without validation
+	 * @param OutPackages One package per unique holder found, in the order of ContextObjects
+	 */
+	void EvaluateContextPackagesParallel(
+		TConstArrayView<UObject*> ContextObjects,
+		TConstArrayView<UContext_ActionEntry*> DefaultEntries,
+		TArray<FContextEntryPackage>& OutPackages) const;
+
+	////////
+	/// ~SPATIAL QUERIES
+
+	/**
+	 * Registers a holder in the spatial index, or moves it if it's already registered
+	 * @param ContextHolder The holder to register
+	 * @param Location Where the holder currently is
+	 */
+	void UpdateSpatialHolder(UObject* ContextHolder, const FVector& Location);
+
+	/**
+	 * Removes a holder from the spatial index
+	 */
+	void UnregisterSpatialHolder(const UObject* ContextHolder);
+
+	/**
+	 * Finds every registered holder within a radius, along with its valid entries. Does not use physics.
+	 * @param Center Center of the sphere
+	 * @param Radius Radius of the sphere
+	 * @param OutPackages One package per holder found
+	 * @param bIncludeHoldersWithoutEntries If false, holders with no valid entries are skipped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Spatial")
+	void FindContextHoldersInRadius(
+		FVector Center,
+		float Radius,
+		TArray<FContextEntryPackage>& OutPackages,
+		bool bIncludeHoldersWithoutEntries = false) const;
+
+	/**
+	 * Finds every registered holder within a box, along with its valid entries. Does not use physics.
+	 * @param Center Center of the box
+	 * @param Extent Half size of the box
+	 * @param OutPackages One package per holder found
+	 * @param bIncludeHoldersWithoutEntries If false, holders with no valid entries are skipped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Spatial")
+	void FindContextHoldersInBox(
+		FVector Center,
+		FVector Extent,
+		TArray<FContextEntryPackage>& OutPackages,
+		bool bIncludeHoldersWithoutEntries = false) const;
+
+	/**
+	 * Finds every registered holder within a view cone, along with its valid entries. Does not use physics.
+	 * @param Origin Tip of the cone, usually the camera location
+	 * @param Direction Direction the cone opens towards, usually the camera forward vector
+	 * @param Length How far from the origin holders are found
+	 * @param HalfAngleDegrees Angle between the direction and the side of the cone
+	 * @param OutPackages One package per holder found
+	 * @param bIncludeHoldersWithoutEntries If false, holders with no valid entries are skipped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Spatial")
+	void FindContextHoldersInCone(
+		FVector Origin,
+		FVector Direction,
+		float Length,
+		float HalfAngleDegrees,
+		TArray<FContextEntryPackage>& OutPackages,
+		bool bIncludeHoldersWithoutEntries = false) const;
+	
+	////////
+	/// ~CACHE
+
+	/**
+	 * Drops the cached entries of every giver. Versioned givers are re-resolved when their version changes and
+	 * unversioned givers are never cached, so this is only needed for givers with a version that missed a change.
+	 * Holders below them will re-resolve their entries on the next query.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void NotifyGiverChanged();
+
+	/**
+	 * Must be called whenever the tree above holders changes shape in a way holders can't detect themselves,
+	 * such as re-parenting a giver widget, attaching/detaching a giver, or renaming a giver into a new outer.
+	 * Holders re-parented themselves already invalidate their own chain.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void NotifyContextTreeChanged();
+
+	/**
+	 * Drops the cached entries of a single holder
+	 * @param ContextHolder The holder to invalidate
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void InvalidateContextCache(const UObject* ContextHolder);
+
+	/**
+	 * Must be called when an entry's RequiredTags or BlockingTags change while playing (editing the entry, for example).
+	 * Recompiles the entry's tag masks, and drops the cached valid entries of every holder, since any of them may hold it.
+	 * @param Entry The entry whose tags changed
+	 */
+	void NotifyEntryTagsChanged(const UContext_ActionEntry* Entry);
+
+	/**
+	 * Gets the versions of everything that affects the entries of a holder: the holder itself and every giver above it.
+	 * @param OutVersion Unversioned (see FContext_TreeVersion::IsVersioned) if the holder or any giver above it is
+	 */
+	void GetContextTreeVersion(const UObject* ContextHolder, FContext_TreeVersion& OutVersion) const;
+
+	/**
+	 * Drops every cached entry, payload and validation result
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void ClearContextCache();
+
+	/**
+	 * Drops the cached payloads of a holder. Call this when a holder's payloads change without its context version
+	 * changing, such as an inventory changing what a loot payload contains.
+	 * @param ContextHolder The holder to invalidate
+	 * @param Entry If set, only the payload for this entry is dropped
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void InvalidatePayloadCache(const UObject* ContextHolder, const UContext_ActionEntry* Entry = nullptr);
+
+	/**
+	 * Gets how many validations were reused from the validation memo, and how many had to be evaluated
+	 * @param OutHits Validations reused
+	 * @param OutMisses Validations evaluated while memoization was possible
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void GetValidationMemoStats(int64& OutHits, int64& OutMisses) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Context|Subsystem|Cache")
+	void ResetValidationMemoStats();
+
+	FContext_ValidationMemo& GetValidationMemo() { return ValidationMemo; }
+
+	FContext_AbilitySystemIndex& GetAbilitySystemIndex() { return AbilitySystemIndex; }
+
+private:
+	/**
+	 * Checks the precomputed menu is for this holder, and that neither the holder nor the tree changed since
+	 */
+	bool IsPrecomputedMenuValid(const UObject* ContextHolder) const;
+
+public:
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	
 	////////
 	/// ~ITERATE OVER CONTEXT OBJECTS
@@ -206,5 +736,100 @@ private:
 	 */
 	UFUNCTION()
 	UObject* GetNextObjectInTree(const UObject* ContextEntity) const;
+
+	/**
+	 * Resolves the valid entries of a holder from scratch, fetching the holder's tags only once
+	 */
+	void ResolveValidContextEntries(const UObject* ContextHolder, TArray<UContext_ActionEntry*>& OutValidEntries) const;
+
+	/**
+	 * Gathers a holder's own entries and the entries passed down by its givers, without filtering them
+	 */
+	template <typename AllocatorType>
+	void GatherRawContextEntries(const UObject* ContextHolder, TArray<UContext_ActionEntry*, AllocatorType>& OutEntries) const;
+
+	/**
+	 * Gets a holder's cached valid entries, if they're still up to date
+	 */
+	const FContext_ValidEntryCache* FindValidEntryCache(const UObject* ContextHolder, const FContext_TreeVersion& TreeVersion) const;
+
+	/**
+	 * Stores freshly resolved valid entries for a holder
+	 */
+	void StoreValidEntryCache(const UObject* ContextHolder, const FContext_TreeVersion& TreeVersion, TConstArrayView<UContext_ActionEntry*> ValidEntries) const;
+
+	/**
+	 * Takes an idle action of the class from its pool, or creates one if the pool is empty
+	 */
+	UContext_Action* AcquirePooledAction(TSubclassOf<UContext_Action> ActionClass);
+
+	/**
+	 * Returns an action to its pool, unless the pool is full
+	 */
+	void ReleasePooledAction(UContext_Action* ContextAction);
+
+	/**
+	 * Gets a holder's cached payload for an entry, if it's still valid under the current cache mode
+	 */
+	bool FindCachedPayload(const UObject* ContextHolder, const UContext_ActionEntry* Entry, const UContext_ActionPayloadBase*& OutPayload) const;
+
+	/**
+	 * Stores a payload freshly requested from a holder
+	 */
+	void StoreCachedPayload(const UObject* ContextHolder, const UContext_ActionEntry* Entry, const UContext_ActionPayloadBase* Payload);
+
+	/**
+	 * Builds packages for holders found by a spatial query
+	 */
+	void BuildSpatialQueryPackages(
+		TConstArrayView<UObject*> ContextHolders,
+		TArray<FContextEntryPackage>& OutPackages,
+		const bool bIncludeHoldersWithoutEntries) const;
+
+	/**
+	 * Gets a holder's owned tags, without copying them if the holder exposes a view
+	 * @param Scratch Receives the tags if they have to be copied
+	 */
+	static const FGameplayTagContainer& GetHolderTags(const IContext_Holder* Holder, FGameplayTagContainer& Scratch);
+
+	/**
+	 * Checks an entry's required and blocking tags against tags that were already fetched from its holder
+	 */
+	bool CanExecuteEntryWithTags(const FGameplayTagContainer& Tags, const UContext_ActionEntry* Entry) const;
+
+	/**
+	 * Gets the givers above the provided holder, walking the tree only if the cached chain is stale.
+	 * @param ContextHolder The holder to start from. Not part of the chain.
+	 * @param MaxDepth The maximum depth to return givers for
+	 * @param OutGivers Givers within MaxDepth, closest first
+	 */
+	void GetGiverChain(const UObject* ContextHolder, const int32 MaxDepth, FContext_GiverLinkArray& OutGivers) const;
+
+	/**
+	 * Walks the tree above the holder and records every giver found
+	 */
+	void BuildGiverChain(const UObject* ContextHolder, const int32 MaxDepth, FContext_GiverChain& OutChain) const;
+
+	/**
+	 * Gets the entries contributed by a giver, asking the giver only if they aren't cached yet.
+	 * Unversioned givers are always asked, and the result is only valid until the next call.
+	 */
+	const TSet<UContext_ActionEntry*>& GetGiverEntries(UObject* Giver) const;
+
+	/**
+	 * Gets the primary entry passed down by a giver, asking the giver only if it isn't cached yet. Unversioned givers
+	 * are always asked.
+	 */
+	UContext_ActionEntry* GetGiverPrimaryEntry(UObject* Giver) const;
+
+	/**
+	 * Gets the cached entries of a versioned giver, resetting them if they were resolved against another version
+	 */
+	FContext_GiverEntries& FindOrAddGiverEntries(const UObject* Giver, uint32 GiverVersion) const;
+
+	/**
+	 * Gets the version of a giver. See IContext_Giver::GetContextVersion
+	 */
+	static uint32 GetGiverVersion(const UObject* Giver);
 	
 };
@@ -0,0 +1,142 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+class UContext_ActionEntry;
+
+/**
+ * Fixed width bitmask over the dense tag index of FContext_TagIndex.
+ * Kept as plain words so matching compiles down to a handful of (vectorizable) AND/compare instructions.
+ */
+struct CONTEXT_API FContext_TagMask {
+	static constexpr int32 NumWords = 4;
+	static constexpr int32 NumBits = NumWords * 64;
+
+	uint64 Words[NumWords] = {};
+
+	FORCEINLINE void SetBit(const int32 Index) {
+		Words[Index >> 6] |= uint64(1) << (Index & 63);
+	}
+
+	FORCEINLINE void Reset() {
+		for (int32 Word = 0; Word < NumWords; ++Word) {
+			Words[Word] = 0;
+		}
+	}
+
+	/** True if every bit set in Other is also set in this mask */
+	FORCEINLINE bool ContainsAll(const FContext_TagMask& Other) const {
+		uint64 Missing = 0;
+		for (int32 Word = 0; Word < NumWords; ++Word) {
+			Missing |= Other.Words[Word] & ~Words[Word];
+		}
+		return Missing == 0;
+	}
+
+	/** True if any bit is set in both masks */
+	FORCEINLINE bool Intersects(const FContext_TagMask& Other) const {
+		uint64 Shared = 0;
+		for (int32 Word = 0; Word < NumWords; ++Word) {
+			Shared |= Other.Words[Word] & Words[Word];
+		}
+		return Shared != 0;
+	}
+};
+
+/**
+ * An entry's required and blocking tags, compiled into masks
+ */
+struct CONTEXT_API FContext_CompiledEntryTags {
+	FContext_TagMask Required;
+	FContext_TagMask Blocking;
+
+	// Set when the tag index ran out of bits for this entry's tags. The entry has to be matched against containers
+	bool bRequiresFallback = false;
+};
+
+/**
+ * A holder's owned tags, converted into masks once per query
+ */
+struct CONTEXT_API FContext_HolderTagMasks {
+	// Owned tags only. Required tags are matched exactly
+	FContext_TagMask Exact;
+
+	// Owned tags and all of their parents. Blocking tags block their children too
+	FContext_TagMask Expanded;
+};
+
+/**
+ * Dense index of every tag referenced by an entry's RequiredTags or BlockingTags.
+ * Entries are compiled into masks over this index the first time they are seen, so matching a holder's tags against
+ * all of its entries doesn't have to walk tag containers.
+ */
+class CONTEXT_API FContext_TagIndex {
+public:
+	/**
+	 * Gets the compiled masks for an entry, compiling it if it hasn't been seen yet
+	 * Compile every entry of a query before building holder masks, as compiling may grow the index.
+	 */
+	const FContext_CompiledEntryTags& CompileEntry(const UContext_ActionEntry* Entry);
+
+	/**
+	 * Drops the compiled masks of an entry whose tags changed, so it is compiled again on next use.
+	 * The tags it referenced stay referenced, which only costs holders a few extra tag events.
+	 */
+	void RemoveEntry(const UContext_ActionEntry* Entry);
+
+	/**
+	 * Converts a holder's tags into masks over the current index
+	 */
+	void BuildHolderMasks(const FGameplayTagContainer& OwnedTags, FContext_HolderTagMasks& OutMasks) const;
+
+	/**
+	 * Checks an entry's masks against a holder's masks. Entries requiring fallback must be matched with containers.
+	 */
+	static FORCEINLINE bool Matches(const FContext_HolderTagMasks& HolderMasks, const FContext_CompiledEntryTags& EntryTags) {
+		return HolderMasks.Exact.ContainsAll(EntryTags.Required) && !HolderMasks.Expanded.Intersects(EntryTags.Blocking);
+	}
+
+	/**
+	 * Checks an entry's tags against a holder's tags using containers. Used for entries requiring fallback.
+	 * Only reads tag data, so it is safe to call from worker threads while the game thread waits on them.
+	 */
+	static FORCEINLINE bool MatchesContainers(
+		const FGameplayTagContainer& OwnedTags,
+		const FGameplayTagContainer& RequiredTags,
+		const FGameplayTagContainer& BlockingTags) {
+		return OwnedTags.HasAllExact(RequiredTags) && !OwnedTags.HasAny(BlockingTags);
+	}
+
+	int32 Num() const { return TagToIndex.Num(); }
+
+	/**
+	 * Checks if the tag, or any of its parents, is required or blocked by any compiled entry
+	 */
+	bool IsReferenced(const FGameplayTag& Tag) const;
+
+	/**
+	 * Changes whenever a compiled entry references tags that weren't referenced before
+	 */
+	uint32 GetReferencedTagsVersion() const { return ReferencedTagsVersion; }
+
+	void Reset();
+
+private:
+	/** Adds tags to the mask, indexing them if needed. Returns false if the index is full */
+	bool AddTagsToMask(const FGameplayTagContainer& Tags, FContext_TagMask& OutMask);
+	
+	/** Adds tags to the referenced tags, bumping the version if any are new */
+	void AddReferencedTags(const FGameplayTagContainer& Tags);
+	
+	TMap<FGameplayTag, int32> TagToIndex;
+
+	/** Every tag used by a compiled entry, including the ones that didn't fit in the index */
+	TSet<FGameplayTag> ReferencedTags;
+	uint32 ReferencedTagsVersion = 1;
+	
+	TMap<TObjectKey<UContext_ActionEntry>, FContext_CompiledEntryTags> CompiledEntries;
+};
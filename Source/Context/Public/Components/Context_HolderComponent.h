@@ -6,8 +6,12 @@
 #include "Components/ActorComponent.h"
 #include "Interface/Context_Giver.h"
 #include "Interface/Context_Holder.h"
+#include "Interface/Context_PayloadFunctionTable.h"
 #include "Context_HolderComponent.generated.h"
 
+class UAbilitySystemComponent;
+class UContext_ActionSubsystem;
+
 DEFINE_LOG_CATEGORY_STATIC(LogContextComponent, Log, All);
 
 UCLASS(ClassGroup=(Custom), Blueprintable, BlueprintType, meta=(BlueprintSpawnableComponent))
@@ -37,6 +41,47 @@ class CONTEXT_API UContext_HolderComponent : public UActorComponent, public ICon
 	 */
 	UPROPERTY(VisibleAnywhere, Category = "Context|Holder|Data")
 	FGameplayTagContainer DefaultTags;
+
+	/**
+	 * If true, this holder is registered with the action subsystem's spatial index and can be found by radius,
+	 * box and cone queries. The index follows the owner as it moves.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Holder|Spatial")
+	bool bRegisterInSpatialIndex = true;
+
+	/**
+	 * Bumped whenever owned tags or entries change. See IContext_Holder::GetContextVersion
+	 * Only reported while we can see every tag change, see GetContextVersion
+	 */
+	uint32 ContextVersion = 1;
+
+	/** Payload class to entry, for RequestPayloadOfType. Dirtied by the entry setters */
+	mutable FContext_PayloadClassIndex PayloadClassIndex;
+
+	/** Ability system we listen to for tag changes, if the owner has one */
+	TWeakObjectPtr<UAbilitySystemComponent> BoundAbilitySystem;
+	FDelegateHandle OwnedTagChangedHandle;
+
+	/**
+	 * Owned tags mirrored from the ability system (or DefaultTags). Refreshed when a tag used by an entry changes,
+	 * or when entries start using new tags. See GetContextTagsMirror
+	 */
+	mutable FGameplayTagContainer OwnedTagsMirror;
+	mutable uint32 MirrorReferencedTagsVersion = 0;
+	mutable bool bOwnedTagsMirrorValid = false;
+
+	/** True if the mirror holds DefaultTags because the ability system had no tags when it was refreshed */
+	mutable bool bMirrorUsesDefaultTags = false;
+
+	/** True if the owner has no ability system, so DefaultTags never change behind our back */
+	bool bUsesDefaultTagsOnly = false;
+
+	/** Action subsystem, cached at BeginPlay */
+	TWeakObjectPtr<UContext_ActionSubsystem> CachedActionSubsystem;
+
+	/** Root component we follow to keep the spatial index up to date */
+	TWeakObjectPtr<USceneComponent> BoundRootComponent;
+	FDelegateHandle TransformUpdatedHandle;
 	
 public:
 	// Sets default values for this component's properties
@@ -56,27 +101,88 @@ public:
 	virtual TArray<UContext_ActionEntry*> GetPrimaryActionEntries_Implementation() const override;
 	
 	virtual const UContext_ActionPayloadBase* RequestPayload_Implementation(const UContext_ActionEntry* ActionEntry) const override;
+
+	/**
+	 * Returns 0 (unversioned) until we listen to the owner's ability system tag events, since tags could change
+	 * without the version moving. Owners without an ability system only use DefaultTags, and are always versioned.
+	 */
+	virtual uint32 GetContextVersion() const override;
+	/** Returns null if a Blueprint overrides GetActionEntries, its entries may not be ContextEntries */
+	virtual const TSet<UContext_ActionEntry*>* GetActionEntriesView() const override;
+	virtual const FGameplayTagContainer* GetOwnedGameplayTagsView() const override { return &GetContextTagsMirror(); }
+	virtual const UFunction* GetPayloadFunction(const UContext_ActionEntry* ActionEntry) const override;
 	
 	// IContext_Holder interface END
 	
 	UFUNCTION(BlueprintCallable, Category = "Skill|Resource|Context")
 	void SetDisplayName(FText Name);
+
+	/**
+	 * Replaces the entries held by this component
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Holder|Entries")
+	void SetContextEntries(const TSet<UContext_ActionEntry*>& Entries);
+
+	/**
+	 * Replaces the priority ordered list of primary entries held by this component
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Holder|Entries")
+	void SetPrimaryContextEntryPriority(const TArray<UContext_ActionEntry*>& Entries);
+
+	/**
+	 * Flags this holder as changed, forcing the action subsystem to re-resolve its entries on the next query.
+	 * Tag changes on the owner's ability system and the setters above already do this for you.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|Holder|Entries")
+	void MarkContextDirty();
 	
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-private:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
-	// Format that is enforced for function names used to get payloads for actions
-	UPROPERTY(VisibleAnywhere)
-	FString ContextPayloadFunctionPrefix = TEXT("GetPayload");
+	// Owner may have changed, so the givers above us may have too
+	virtual void OnRegister() override;
+	virtual void PostRename(UObject* OldOuter, const FName OldName) override;
+
+private:
 
 #if WITH_EDITOR
 	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
 #endif
 
-	UFUNCTION(BlueprintCallable)
-	UFunction* GetFunctionForAction(const FString&  ActionName, FName& ExpectedFunctionName) const;
+	/**
+	 * Finds the payload function for an entry through the per class payload function table
+	 * @param ExpectedFunctionName Name the function is expected to have, for reporting
+	 */
+	UFunction* GetFunctionForAction(const UContext_ActionEntry* ActionEntry, FName& ExpectedFunctionName) const;
+
+	void OnOwnedTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	/**
+	 * Gets the owned tags without copying them, for entry filtering only. Kept in sync from the ability system's tag
+	 * change events, but changes to tags no entry uses are ignored until an entry starts using them.
+	 * Everything else should use GetOwnedGameplayTags, which is always up to date.
+	 */
+	const FGameplayTagContainer& GetContextTagsMirror() const;
+
+	/**
+	 * Listens to the tag events of the owner's ability system, if it has one yet. The ASC may only show up after
+	 * BeginPlay (owned by the PlayerState, initialized late), or change on possession, so this is retried on query.
+	 * @return True if we're bound to the owner's current ability system
+	 */
+	bool TryBindAbilitySystem();
+	void UnbindAbilitySystem();
+
+	// Copies the owned tags from the ability system, or DefaultTags if it has none
+	void RefreshOwnedTagsMirror() const;
+
+	void OnOwnerTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	UContext_ActionSubsystem* GetActionSubsystem() const;
+
+	// Drops everything the action subsystem has cached for this holder
+	void InvalidateCachedContext() const;
 
 };
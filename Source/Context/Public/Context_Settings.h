@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "Context_Settings.generated.h"
+
+class UContext_Menu;
+
+/**
+ * How long payloads requested from holders are reused for
+ */
+UENUM(BlueprintType)
+enum class EContext_PayloadCacheMode : uint8 {
+	/** Payloads are requested from the holder on every execution */
+	Disabled,
+	/** Payloads are reused until the holder changes or the cache is invalidated */
+	Persistent,
+	/** Payloads are reused within the frame they were requested in */
+	Frame,
+};
+
+/**
+ * Project wide settings for the Context plugin. Found under Project Settings > Plugins > Context
+ */
+UCLASS(Config=Context, DefaultConfig, meta=(DisplayName="Context"))
+class CONTEXT_API UContext_Settings : public UDeveloperSettings {
+	GENERATED_BODY()
+
+public:
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	/**
+	 * How long payloads are cached for. Only enable this if your payload getters return the same payload for as long
+	 * as the holder is unchanged, or call InvalidatePayloadCache when they wouldn't.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Payload")
+	EContext_PayloadCacheMode PayloadCacheMode = EContext_PayloadCacheMode::Disabled;
+
+	/**
+	 * How many idle instances of each pooled action class are kept around. See EContext_ActionExecutionMode::Pooled
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Action", meta=(ClampMin=0))
+	int32 MaxPooledActionsPerClass = 8;
+
+	/**
+	 * If true, validation results are reused according to each validation's ValidationDependency.
+	 * Validations are only reused if they opted in, see UContext_ActionValidation::ValidationDependency
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Validation")
+	bool bMemoizeValidations = true;
+
+	/**
+	 * Menu loaded in the background and built offscreen when the game instance starts, so the first menu opened
+	 * doesn't hitch. A UContext_SystemComponent with a ContextMenuTemplate always uses its template instead, whether or
+	 * not this finished loading first. If empty, the template is built when the component begins play.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "UI")
+	TSoftClassPtr<UContext_Menu> ContextMenuClass;
+
+	/**
+	 * How many entry buttons are built with the menu, before it's ever opened
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "UI", meta=(ClampMin=0))
+	int32 PrewarmedEntryButtons = 8;
+};
@@ -0,0 +1,51 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+/**
+ * Profiling for the Context plugin.
+ * "stat Context" shows per frame times and counts, and the Context trace channel (-trace=cpu,counters,context) names
+ * the plugin's scopes in Unreal Insights.
+ */
+
+UE_TRACE_CHANNEL_EXTERN(ContextChannel, CONTEXT_API);
+
+DECLARE_STATS_GROUP(TEXT("Context"), STATGROUP_Context, STATCAT_Advanced);
+
+/// Times
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Open Menu Trace"), STAT_Context_OpenMenuTrace, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Valid Entries"), STAT_Context_GetValidEntries, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tree Aggregation"), STAT_Context_TreeAggregation, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Can Execute Entry"), STAT_Context_CanExecuteEntry, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Run Validations"), STAT_Context_RunValidations, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Payload Request"), STAT_Context_PayloadRequest, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Action"), STAT_Context_CreateAction, STATGROUP_Context, CONTEXT_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Show Menu"), STAT_Context_ShowMenu, STATGROUP_Context, CONTEXT_API);
+
+/// Per frame counts
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Entry Queries"), STAT_Context_NumEntryQueries, STATGROUP_Context, CONTEXT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Entry Checks"), STAT_Context_NumEntryChecks, STATGROUP_Context, CONTEXT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Validation Runs"), STAT_Context_NumValidationRuns, STATGROUP_Context, CONTEXT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Payload Requests"), STAT_Context_NumPayloadRequests, STATGROUP_Context, CONTEXT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actions Created"), STAT_Context_NumActionsCreated, STATGROUP_Context, CONTEXT_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Menus Shown"), STAT_Context_NumMenusShown, STATGROUP_Context, CONTEXT_API);
+
+/// Latency of the last menu opened, from the input opening it to the menu's first tick on screen
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Input To Menu Visible (ms)"), STAT_Context_InputToMenuVisibleMs, STATGROUP_Context, CONTEXT_API);
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(Context_EntryQueries);
+TRACE_DECLARE_INT_COUNTER_EXTERN(Context_ValidationRuns);
+TRACE_DECLARE_INT_COUNTER_EXTERN(Context_PayloadRequests);
+TRACE_DECLARE_INT_COUNTER_EXTERN(Context_ActionsCreated);
+TRACE_DECLARE_FLOAT_COUNTER_EXTERN(Context_InputToMenuVisibleMs);
+
+/** Times the enclosing scope in both the stat group and the Context trace channel */
+#define CONTEXT_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, ContextChannel)
@@ -4,15 +4,23 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h"
+#include "Actions/Context_ActionSubsystem.h"
 #include "Context_SystemComponent.generated.h"
 
 class UContext_ActionSubsystem;
+class UContext_Menu;
 class UInputMappingContext;
 class UContext_ActionEntry;
 class UInputAction;
 
 DEFINE_LOG_CATEGORY_STATIC(LogContextSystem, Log, All);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(
+	FContext_OnHoveredContextChanged,
+	UObject*, HoveredContextHolder,
+	UContext_ActionEntry*, PrimaryEntry);
+
 /**
  * Context system allowing an actor (The player, most likely) to interact with the Context library by responding to
  * input actions.
@@ -21,8 +29,11 @@ UCLASS()
 class CONTEXT_API UContext_SystemComponent : public UActorComponent {
 	GENERATED_BODY()
 
+	/**
+	 * The menu to use. Takes priority over UContext_Settings::ContextMenuClass, which is only used if this is empty
+	 */
 	UPROPERTY(EditDefaultsOnly)
-	TSubclassOf<UUserWidget> ContextMenuTemplate;
+	TSubclassOf<UContext_Menu> ContextMenuTemplate;
 	
 	/**
 	 * The input that will be used to activate the context menu
@@ -48,14 +59,146 @@ class CONTEXT_API UContext_SystemComponent : public UActorComponent {
 
 	UPROPERTY()
 	UContext_ActionSubsystem* ActionSubsystem;
+
+	/**
+	 * Channel traced under the cursor to find holders. Ideally a trace channel set up in the project's collision
+	 * settings that only holders respond to, so the trace doesn't return every visible primitive along the ray.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Trace", meta=(AllowPrivateAccess = true))
+	TEnumAsByte<ECollisionChannel> ContextTraceChannel = ECC_Visibility;
+
+	/**
+	 * How far from the camera holders can be found
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Trace", meta=(AllowPrivateAccess = true, ClampMin=0, Units="Centimeters"))
+	float MaxTraceDistance = 10000.f;
+
+	/**
+	 * Holders further than this behind the first thing hit are ignored, so clutter behind what was clicked doesn't
+	 * end up in the menu. 0 keeps everything up to the first blocking hit.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Trace", meta=(AllowPrivateAccess = true, ClampMin=0, Units="Centimeters"))
+	float OcclusionCutoffDistance = 0.f;
+
+	/**
+	 * If true, the menu trace runs asynchronously and the menu opens with its results the next frame
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Trace", meta=(AllowPrivateAccess = true))
+	bool bUseAsyncTrace = false;
+
+	/// Async trace state
+
+	FTraceHandle PendingMenuTrace;
+	FTraceDelegate MenuTraceDelegate;
+
+	/**
+	 * If true, the holder under the cursor is tracked and its primary entry broadcast through OnHoveredContextChanged.
+	 * Useful for interaction prompts.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Hover", meta=(AllowPrivateAccess = true))
+	bool bEnableHoverTracking = false;
+
+	/**
+	 * Seconds between hover traces
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Hover", meta=(AllowPrivateAccess = true, EditCondition="bEnableHoverTracking", ClampMin=0))
+	float HoverTraceInterval = 0.1f;
+
+	/**
+	 * If neither the cursor moved further than this (in pixels) nor the camera moved since the last trace,
+	 * the trace is skipped as it would hit the same thing
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Hover", meta=(AllowPrivateAccess = true, EditCondition="bEnableHoverTracking", ClampMin=0))
+	float HoverCursorDeadZone = 2.f;
+
+	/**
+	 * Seconds the cursor has to rest on a holder before its menu is computed ahead of a click, so opening it is
+	 * instant. 0 never computes menus ahead of time.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|System|Hover", meta=(AllowPrivateAccess = true, EditCondition="bEnableHoverTracking", ClampMin=0, Units="Seconds"))
+	float HoverDwellTime = 0.25f;
+
+	/// Hover state
+	
+	UPROPERTY()
+	TWeakObjectPtr<UObject> HoveredContextHolder;
+
+	UPROPERTY()
+	UContext_ActionEntry* HoveredPrimaryEntry = nullptr;
+
+	FContext_TreeVersion HoveredContextVersion;
+	bool bHasHoverTraced = false;
+	FVector2D LastHoverMousePosition = FVector2D::ZeroVector;
+	FVector LastHoverCameraLocation = FVector::ZeroVector;
+	FRotator LastHoverCameraRotation = FRotator::ZeroRotator;
+	double HoverStartTime = 0.0;
+	bool bHoverMenuPrecomputed = false;
 	
 public:
 	// Sets default values for this actor's properties
 	UContext_SystemComponent();
 
+	/**
+	 * Called whenever the holder under the cursor, or its primary entry, changes. Both may be null.
+	 */
+	UPROPERTY(BlueprintAssignable, Category = "Context|System|Hover")
+	FContext_OnHoveredContextChanged OnHoveredContextChanged;
+
+	/**
+	 * Starts or stops tracking the holder under the cursor
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|System|Hover")
+	void SetHoverTrackingEnabled(bool bEnabled);
+
+	/**
+	 * Gets the holder currently under the cursor, if hover tracking is enabled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|System|Hover")
+	UObject* GetHoveredContextHolder() const { return HoveredContextHolder.Get(); }
+
+	/**
+	 * Gets the primary entry of the holder currently under the cursor, if hover tracking is enabled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Context|System|Hover")
+	UContext_ActionEntry* GetHoveredPrimaryEntry() const { return HoveredPrimaryEntry; }
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
 private:
 	UFUNCTION()
 	APlayerController* GetCurrentActorController() const;
+
+	/**
+	 * Deprojects the cursor into the world
+	 * @return False if there is no cursor to deproject
+	 */
+	bool GetCursorRay(const APlayerController* PlayerController, FVector2D& OutMousePosition, FVector& OutStart, FVector& OutDirection) const;
+
+	/**
+	 * Traces under the cursor and updates the hovered holder, if anything relevant changed since the last trace
+	 */
+	void UpdateHover();
+
+	/**
+	 * Sets the hovered holder, resolving its primary entry only if the holder or its context version changed
+	 */
+	void SetHoveredContextHolder(UObject* ContextHolder);
+
+	/**
+	 * Computes the menu of the hovered holder once the cursor rested on it for HoverDwellTime
+	 */
+	void UpdateHoverDwell();
+
+	/**
+	 * Receives the async menu trace, and opens the menu for what it hit unless another trace was started since
+	 */
+	void OnMenuTraceCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/**
+	 * Opens the context menu for every holder hit, once per actor, in hit order
+	 * @param Hits Hits sorted by distance, as returned by a multi trace
+	 */
+	void ShowContextMenuForHits(const TArray<FHitResult>& Hits);
 	
 protected:
 	UFUNCTION()
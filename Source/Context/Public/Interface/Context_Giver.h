@@ -17,6 +17,10 @@ class CONTEXT_API UContext_Giver : public UInterface {
 /**
  * A context giver interface signifies that this entity should pass a context down to its children
  * This allows context objects to understand their hierarchy.
+ *
+ * Entries of versioned givers (see GetContextVersion) are cached by the action subsystem. Unversioned givers are asked
+ * again on every query. Implementations must call UContext_ActionSubsystem::NotifyContextTreeChanged when they are
+ * re-parented, attached or detached.
  */
 class CONTEXT_API IContext_Giver {
 	GENERATED_BODY()
@@ -54,4 +58,11 @@ public:
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Context|Giver|Payload")
 	UContext_ActionPayloadBase* RequestContextPayload(TSubclassOf<UContext_ActionPayloadBase> PayloadClass);
+
+	/**
+	 * Version of the entries and primary entry this giver passes down. Must change whenever either changes.
+	 * Givers returning 0 are treated as unversioned: they're asked for their entries on every query, and holders below
+	 * them can't cache their resolved entries.
+	 */
+	virtual uint32 GetContextVersion() const { return 0; }
 };
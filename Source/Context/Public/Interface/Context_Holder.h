@@ -11,6 +11,7 @@
 class UContext_Action;
 class UContext_ActionPayloadBase;
 class UContext_ActionEntry;
+class UFunction;
 
 UINTERFACE(BlueprintType, Blueprintable)
 class CONTEXT_API UContext_Holder : public UInterface {
@@ -66,5 +67,32 @@ public:
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Context|Holder|Action")
 	const UContext_ActionPayloadBase* RequestPayload(const UContext_ActionEntry* ActionEntry) const;
+
+	/**
+	 * Version of everything that affects which entries are valid on this holder (owned tags, entries, primary entries).
+	 * Must change whenever any of those change. The action subsystem uses it to cache resolved entries.
+	 * Holders returning 0 are treated as unversioned, and are re-resolved on every query.
+	 */
+	virtual uint32 GetContextVersion() const { return 0; }
+
+	/**
+	 * Native access to the entries held by this holder, without copying them.
+	 * Returns null if the entries are only available through GetActionEntries (Blueprint holders, for example).
+	 */
+	virtual const TSet<UContext_ActionEntry*>* GetActionEntriesView() const { return nullptr; }
+
+	/**
+	 * Native access to the tags owned by this holder, without copying them, for the action subsystem to filter entries.
+	 * May ignore tags no entry references, so anything else should use GetOwnedGameplayTags.
+	 * Returns null if the tags are only available through GetOwnedGameplayTags.
+	 */
+	virtual const FGameplayTagContainer* GetOwnedGameplayTagsView() const { return nullptr; }
+
+	/**
+	 * Native access to the function RequestPayload calls for an entry. Entries resolving to the same function get the
+	 * same payload, so the action subsystem only requests it once for all of them.
+	 * Returns null if the payload isn't known to come from such a function (Blueprint RequestPayload, for example).
+	 */
+	virtual const UFunction* GetPayloadFunction(const UContext_ActionEntry* ActionEntry) const { return nullptr; }
 	
 };
@@ -0,0 +1,71 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/SoftObjectPath.h"
+
+class UContext_ActionEntry;
+
+/**
+ * Per class lookup of the payload function a holder defines for an entry.
+ * Each class/entry pair is resolved through FindFunction once, every later lookup is a hash lookup.
+ */
+class CONTEXT_API FContext_PayloadFunctionTable {
+public:
+	/**
+	 * Finds the payload function defined on a class for an entry
+	 * @param Class Class the payload function is defined on
+	 * @param Entry Entry the payload is for
+	 * @return Payload function, or null if the class doesn't define one
+	 */
+	static UFunction* FindPayloadFunction(const UClass* Class, const UContext_ActionEntry* Entry);
+
+	/**
+	 * Resolves the payload functions of a holder's entries up front, so the first execution doesn't pay for it
+	 */
+	static void WarmClass(
+		const UClass* Class,
+		const TSet<UContext_ActionEntry*>& Entries,
+		const TArray<UContext_ActionEntry*>& PrimaryEntries);
+
+	/**
+	 * Drops every resolved function. Called when entries change their payload identifier.
+	 */
+	static void Reset();
+
+private:
+	struct FClassTable {
+		TMap<TObjectKey<UContext_ActionEntry>, TWeakObjectPtr<UFunction>> Functions;
+	};
+
+	static TMap<TObjectKey<UClass>, FClassTable> ClassTables;
+};
+
+/**
+ * Holder-local index from payload class to the entry that provides it, for RequestPayloadOfType.
+ * Holders mark it dirty when their entries change, and it's rebuilt on the next lookup. It also stays dirty while an
+ * entry's payload class is unknown (see UContext_ActionEntry::IsActionPayloadClassKnown), so the entry is picked up
+ * once its action is streamed in.
+ */
+class CONTEXT_API FContext_PayloadClassIndex {
+public:
+	/**
+	 * Finds the entry providing the payload class, rebuilding the index first if it's dirty or incomplete.
+	 * Regular entries take precedence over primary entries.
+	 */
+	UContext_ActionEntry* Find(
+		const UClass* PayloadClass,
+		const TSet<UContext_ActionEntry*>& Entries,
+		const TArray<UContext_ActionEntry*>& PrimaryEntries);
+
+	void MarkDirty() { bDirty = true; }
+
+private:
+	void Rebuild(const TSet<UContext_ActionEntry*>& Entries, const TArray<UContext_ActionEntry*>& PrimaryEntries);
+	
+	/** Keyed on the payload class path, payload classes of actions that aren't loaded may not be loaded either */
+	TMap<FSoftObjectPath, UContext_ActionEntry*> EntriesByPayloadClass;
+	bool bDirty = true;
+};
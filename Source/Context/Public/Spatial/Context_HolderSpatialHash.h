@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Uniform spatial hash grid of context holders, keyed on their position.
+ * Lets the action subsystem find holders around a point without touching physics.
+ */
+class CONTEXT_API FContext_HolderSpatialHash {
+public:
+	explicit FContext_HolderSpatialHash(const float InCellSize = 1000.f);
+
+	/**
+	 * Adds a holder at the provided location, or moves it if it's already registered
+	 */
+	void Update(UObject* Holder, const FVector& Location);
+
+	void Remove(const UObject* Holder);
+
+	void Reset();
+
+	int32 Num() const { return ItemIndices.Num(); }
+
+	/**
+	 * Finds every holder positioned inside the box
+	 */
+	void QueryBox(const FBox& Box, TArray<UObject*>& OutHolders) const;
+
+	/**
+	 * Finds every holder positioned inside the sphere
+	 */
+	void QuerySphere(const FVector& Center, const float Radius, TArray<UObject*>& OutHolders) const;
+
+	/**
+	 * Finds every holder positioned inside the cone
+	 * @param Origin Tip of the cone
+	 * @param Direction Direction the cone opens towards. Doesn't need to be normalized.
+	 * @param Length How far from the origin holders are found
+	 * @param HalfAngleRadians Angle between the direction and the side of the cone
+	 */
+	void QueryCone(
+		const FVector& Origin,
+		const FVector& Direction,
+		const float Length,
+		const float HalfAngleRadians,
+		TArray<UObject*>& OutHolders) const;
+
+private:
+	struct FItem {
+		TWeakObjectPtr<UObject> Holder;
+		FVector Location = FVector::ZeroVector;
+		FIntVector Cell = FIntVector::ZeroValue;
+	};
+	
+	FIntVector GetCell(const FVector& Location) const;
+
+	/**
+	 * Calls Visitor on every item stored in cells overlapping the box. Items may be outside the box itself.
+	 */
+	template <typename VisitorType>
+	void ForEachItemInCells(const FBox& Box, VisitorType&& Visitor) const;
+
+	void AddToCell(const FIntVector& Cell, const int32 ItemIndex);
+	void RemoveFromCell(const FIntVector& Cell, const int32 ItemIndex);
+	
+	float CellSize;
+	
+	TSparseArray<FItem> Items;
+	TMap<TObjectKey<UObject>, int32> ItemIndices;
+	TMap<FIntVector, TArray<int32>> Cells;
+};
@@ -36,6 +36,12 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void Setup(AActor* Instigator, const UContext_ActionEntry* ContextEntry, const TScriptInterface<IContext_Holder> ContextHolder); 
 
+	/**
+	 * Clears the entry this button was set up with, so a pooled button doesn't keep its holder alive
+	 */
+	UFUNCTION(BlueprintCallable)
+	void Reset();
+
 private:
 
 	UFUNCTION()
@@ -0,0 +1,27 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/IUserObjectListEntry.h"
+#include "Blueprint/UserWidget.h"
+#include "Components/TextBlock.h"
+#include "Context_EntryRow.generated.h"
+
+/**
+ * A row of a UContext_ListMenu, displaying a UContext_MenuEntryData. Rows are recycled by the list as it scrolls.
+ * Clicks are handled by the menu.
+ */
+UCLASS(Abstract)
+class CONTEXT_API UContext_EntryRow : public UUserWidget, public IUserObjectListEntry {
+	GENERATED_BODY()
+
+	UPROPERTY(meta=(BindWidget))
+	TWeakObjectPtr<UTextBlock> ContextActionName;
+
+	UPROPERTY(meta=(BindWidget))
+	TWeakObjectPtr<UTextBlock> ContextEntityName;
+
+protected:
+	virtual void NativeOnListItemObjectSet(UObject* ListItemObject) override;
+};
@@ -0,0 +1,53 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UI/Context_Menu.h"
+#include "Context_ListMenu.generated.h"
+
+class UListView;
+class UContext_MenuEntryData;
+
+/**
+ * A context menu for holders with a lot of entries (banks, crafting stations).
+ *
+ * Entries are displayed in a list view, which only builds rows (see UContext_EntryRow) for the entries on screen.
+ * Every entry is a small UContext_MenuEntryData, reused between menus, so opening the menu costs about the same no
+ * matter how many entries there are.
+ */
+UCLASS()
+class CONTEXT_API UContext_ListMenu : public UContext_Menu {
+	GENERATED_BODY()
+
+	/// widget elements
+
+	/**
+	 * The list displaying the entries. Its entry widget class should be a UContext_EntryRow
+	 */
+	UPROPERTY(meta=(BindWidget))
+	TWeakObjectPtr<UListView> ContextEntryList;
+
+	/**
+	 * Every entry data object created so far. The first NumActiveEntryData are in the list, the rest are cleared and
+	 * waiting to be reused.
+	 */
+	UPROPERTY()
+	TArray<UContext_MenuEntryData*> EntryDataPool;
+
+	int32 NumActiveEntryData = 0;
+
+	/// Items currently handed to the list, kept to avoid reallocating it every time
+	UPROPERTY()
+	TArray<UContext_MenuEntryData*> ListItems;
+
+protected:
+	virtual void NativeOnInitialized() override;
+	
+	virtual void PopulateEntries(const TArray<FContextEntryPackage>& ContextEntryPackage) override;
+
+	virtual void ReleaseEntries() override;
+
+private:
+	void EntryClicked(UObject* Item);
+};
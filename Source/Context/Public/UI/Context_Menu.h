@@ -8,11 +8,25 @@
 #include "Components/Button.h"
 #include "Context_Menu.generated.h"
 
+DEFINE_LOG_CATEGORY_STATIC(LogContextMenu, Log, All);
+
 class UVerticalBox;
 class UCommonButtonBase;
 class UContext_ActionEntry;
 class IContext_Holder;
 class UContext_EntryButton;
+
+/**
+ * How a menu shown at a world location follows the camera
+ */
+UENUM(BlueprintType)
+enum class EContext_MenuAnchorMode : uint8 {
+	/** Projected again every frame */
+	EveryFrame,
+	/** Projected again only when the camera or viewport changed by more than the menu's thresholds */
+	OnViewChange,
+};
+
 /**
  * A context menu is a container for all context entry buttons.
  *
@@ -31,22 +45,82 @@ class CONTEXT_API UContext_Menu : public UUserWidget {
 	 */
 	UPROPERTY(EditDefaultsOnly, Category = "Context|Settings")
 	bool bShouldBeStaticOnScreen = false;
+
+	/**
+	 * How the menu follows the camera when it isn't static on screen
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Settings", meta = (EditCondition = "!bShouldBeStaticOnScreen"))
+	EContext_MenuAnchorMode AnchorMode = EContext_MenuAnchorMode::OnViewChange;
+
+	/**
+	 * Distance the camera has to move before the menu is projected again
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Settings", meta = (EditCondition = "!bShouldBeStaticOnScreen && AnchorMode == EContext_MenuAnchorMode::OnViewChange", ClampMin = 0, Units = "Centimeters"))
+	float ReprojectLocationThreshold = 0.5f;
+
+	/**
+	 * Angle the camera has to turn (or zoom) before the menu is projected again
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Settings", meta = (EditCondition = "!bShouldBeStaticOnScreen && AnchorMode == EContext_MenuAnchorMode::OnViewChange", ClampMin = 0, Units = "Degrees"))
+	float ReprojectAngleThreshold = 0.05f;
 	
 	UPROPERTY(EditDefaultsOnly, meta=(AllowPrivateAccess=true), Category = "Context|Setup")
-	TSubclassOf<UButton> EntryButtonTemplate;
+	TSubclassOf<UContext_EntryButton> EntryButtonTemplate;
+
+	/**
+	 * Entry buttons are kept around between menus and only set up again when reused.
+	 * This many buttons are kept when the pool is trimmed.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Pooling", meta = (ClampMin = 0))
+	int32 MinPooledEntryButtons = 8;
+
+	/**
+	 * Seconds after the menu is hidden before unused buttons above MinPooledEntryButtons are destroyed.
+	 * 0 never trims the pool.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Context|Pooling", meta = (ClampMin = 0))
+	float EntryButtonPoolTrimDelay = 30.f;
 
 	/// widget elements
 	
-	UPROPERTY(meta=(BindWidget))
+	/**
+	 * Holds the entry buttons. Optional, since menu variants such as UContext_ListMenu display entries differently
+	 */
+	UPROPERTY(meta=(BindWidgetOptional))
 	TWeakObjectPtr<UVerticalBox> ContextButtonContainer;
 	
+	/**
+	 * Every entry button in ContextButtonContainer, in order. The first NumActiveEntryButtons are in use,
+	 * the rest are collapsed and waiting to be reused.
+	 */
 	UPROPERTY()
 	TArray<UContext_EntryButton*> ContextEntryButtons;
 
+	int32 NumActiveEntryButtons = 0;
+
+	FTimerHandle TrimEntryButtonPoolHandle;
+
 	/// Fields
 	
 	UPROPERTY()
 	FVector WorldLocation = FVector::Zero();
+
+	/**
+	 * When input asked for this menu. Cleared on the first tick after showing, once the latency has been recorded
+	 */
+	uint64 MenuRequestCycles = 0;
+
+	/**
+	 * True while the menu is shown and has something to update in its tick. The widget's tick is switched off
+	 * otherwise, unless something else needs it. See SetTickEnabled
+	 */
+	bool bUpdating = false;
+
+	/// View the menu was last projected with
+	FVector LastProjectedCameraLocation = FVector::ZeroVector;
+	FRotator LastProjectedCameraRotation = FRotator::ZeroRotator;
+	float LastProjectedFOV = 0.f;
+	FIntPoint LastProjectedViewportSize = FIntPoint::ZeroValue;
 	
 public:
 	/**
@@ -73,12 +147,68 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void HideMenu();
 
-	UFUNCTION()
+	virtual void NativeDestruct() override;
+
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
+	/**
+	 * Builds entry buttons ahead of time, so the first menus opened don't have to
+	 * @param NumButtons How many buttons the pool should have
+	 */
+	void PrewarmEntryButtons(const int32 NumButtons);
+
+protected:
+	/**
+	 * Creates the UI for every entry. By default, sets up one pooled entry button per entry.
+	 * @param ContextEntryPackage Entries to display, with the holder they're for
+	 */
+	virtual void PopulateEntries(const TArray<FContextEntryPackage>& ContextEntryPackage);
+
+	/**
+	 * Clears the UI for the entries currently displayed
+	 */
+	virtual void ReleaseEntries();
+
 private:
 	UFUNCTION()
 	void ShowMenuInternal(const FVector2D ScreenSpaceLocation,
 	                      const TArray<FContextEntryPackage>& ContextEntryPackage,
 	                      const bool bRemoveDPIScale = true);
+
+	/**
+	 * Records how long the menu took to show, and keeps a world anchored menu on its world location.
+	 * Runs in the widget's tick, which is ordered after the camera update and before the menu is painted.
+	 * @return False once there is nothing left to update
+	 */
+	bool UpdateMenu();
+
+	/**
+	 * Projects WorldLocation to the screen again, if the view changed enough since the last time
+	 */
+	void UpdateWorldAnchor();
+
+	bool IsWorldAnchored() const { return !bShouldBeStaticOnScreen && WorldLocation != FVector::Zero(); }
+
+	void StartUpdating();
+	void StopUpdating();
+
+	/**
+	 * Switches the widget's tick on or off. Stays on while Blueprint ticks, animations or latent actions need it.
+	 */
+	void SetTickEnabled(bool bEnabled);
+
+	/**
+	 * Gets the pooled entry button at Index, creating buttons up to it if the pool is too small
+	 */
+	UContext_EntryButton* GetOrCreateEntryButton(const int32 Index);
+
+	/**
+	 * Collapses and clears every active entry button, returning them to the pool
+	 */
+	void ReleaseEntryButtons();
+
+	/**
+	 * Destroys unused buttons above MinPooledEntryButtons
+	 */
+	void TrimEntryButtonPool();
 };
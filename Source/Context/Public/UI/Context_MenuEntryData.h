@@ -0,0 +1,38 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interface/Context_Holder.h"
+#include "UObject/Object.h"
+#include "Context_MenuEntryData.generated.h"
+
+class UContext_ActionEntry;
+
+/**
+ * A single row of a UContext_ListMenu. Rows are only built for the entries on screen, this is what every entry gets.
+ */
+UCLASS(BlueprintType)
+class CONTEXT_API UContext_MenuEntryData : public UObject {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Menu")
+	const UContext_ActionEntry* ContextEntry = nullptr;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Menu")
+	TScriptInterface<IContext_Holder> ContextHolder;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Context|Menu")
+	AActor* InstigatingActor = nullptr;
+
+	void Setup(AActor* Instigator, const UContext_ActionEntry* Entry, const TScriptInterface<IContext_Holder>& Holder) {
+		InstigatingActor = Instigator;
+		ContextEntry = Entry;
+		ContextHolder = Holder;
+	}
+
+	void Reset() {
+		Setup(nullptr, nullptr, nullptr);
+	}
+};
@@ -6,6 +6,7 @@
 #include "CommonBorder.h"
 #include "Blueprint/UserWidget.h"
 #include "Interface/Context_Holder.h"
+#include "Interface/Context_PayloadFunctionTable.h"
 #include "Context_UIWidgetBase.generated.h"
 
 /**
@@ -29,6 +30,22 @@ class CONTEXT_API UContext_UIWidgetBase : public UUserWidget, public IContext_Ho
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true), Category = "Context|UI")
 	TArray<UContext_ActionEntry*> PrimaryContextEntryPriority;
+
+	/**
+	 * Bumped whenever tags or entries change. See IContext_Holder::GetContextVersion
+	 */
+	uint32 ContextVersion = 1;
+
+	/** Payload class to entry, for RequestPayloadOfType. Dirtied by the entry setters */
+	mutable FContext_PayloadClassIndex PayloadClassIndex;
+
+	/**
+	 * If true, the menu of this element is computed when the cursor enters it, so right clicking it is instant.
+	 * Every mouse enter then runs a full entry query and streams in the entries' assets, so only enable this on
+	 * elements that are hovered on purpose rather than swept over (not every slot of a large grid).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true), Category = "Context|UI")
+	bool bPrecomputeMenuOnHover = false;
 	
 private:
 	
@@ -36,6 +53,14 @@ private:
 	virtual FReply NativeOnMouseButtonDown(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
 
 	virtual FReply NativeOnMouseButtonDoubleClick(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+	virtual void NativeOnMouseEnter(const FGeometry& InGeometry, const FPointerEvent& InMouseEvent) override;
+
+protected:
+	// Constructing or destructing means we've been (re)parented, so the givers above us may have changed
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+	
 public:
 	
 	/**
@@ -51,6 +76,19 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category="Context|UI|Tags")
 	void ClearTags();
+
+	/// Replaces the entries held by this UI element
+	UFUNCTION(BlueprintCallable, Category="Context|UI|Entries")
+	void SetContextEntries(const TSet<UContext_ActionEntry*>& Entries);
+
+	/// Replaces the priority ordered list of primary entries held by this UI element
+	UFUNCTION(BlueprintCallable, Category="Context|UI|Entries")
+	void SetPrimaryContextEntryPriority(const TArray<UContext_ActionEntry*>& Entries);
+
+	/// Flags this UI element as changed, forcing the action subsystem to re-resolve its entries on the next query.
+	/// Tag and entry setters already do this for you.
+	UFUNCTION(BlueprintCallable, Category="Context|UI|Entries")
+	void MarkContextDirty();
 	
 	// ~IContext_Holder Implementation
 	
@@ -64,6 +102,10 @@ public:
 	virtual TArray<UContext_ActionEntry*> GetPrimaryActionEntries_Implementation() const override;
 	virtual const UContext_ActionPayloadBase* RequestPayload_Implementation(const UContext_ActionEntry* ActionEntry) const override;
 	virtual FText GetDisplayName_Implementation() const override;
+	virtual uint32 GetContextVersion() const override { return ContextVersion; }
+	virtual const TSet<UContext_ActionEntry*>* GetActionEntriesView() const override;
+	virtual const FGameplayTagContainer* GetOwnedGameplayTagsView() const override { return &DefaultTags; }
+	virtual const UFunction* GetPayloadFunction(const UContext_ActionEntry* ActionEntry) const override;
 	// !IContext_Holder Implementation
 
 private:
@@ -71,7 +113,13 @@ private:
 	virtual EDataValidationResult IsDataValid(FDataValidationContext& Context) const override;
 #endif
 
-	UFUNCTION(BlueprintCallable)
-	UFunction* GetFunctionForAction(const FString&  ActionName, FName& ExpectedFunctionName) const;
+	/**
+	 * Finds the payload function for an entry through the per class payload function table
+	 * @param ExpectedFunctionName Name the function is expected to have, for reporting
+	 */
+	UFunction* GetFunctionForAction(const UContext_ActionEntry* ActionEntry, FName& ExpectedFunctionName) const;
+
+	// Drops everything the action subsystem has cached for this holder
+	void InvalidateCachedContext() const;
 	
 };
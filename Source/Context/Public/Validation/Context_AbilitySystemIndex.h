@@ -0,0 +1,111 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
+
+class UAbilitySystemComponent;
+
+/**
+ * Tracks the ability systems validations look at. Keeps versions of their tags and granted abilities, bumped from
+ * their change events, and an index of granted abilities by ability tag so has-ability checks don't scan every spec.
+ * Owned by the action subsystem, and stops listening to every ability system when torn down. Game thread only.
+ */
+class CONTEXT_API FContext_AbilitySystemIndex {
+public:
+	FContext_AbilitySystemIndex() = default;
+	~FContext_AbilitySystemIndex();
+
+	// Ability systems hold delegates bound to this index
+	FContext_AbilitySystemIndex(const FContext_AbilitySystemIndex&) = delete;
+	FContext_AbilitySystemIndex& operator=(const FContext_AbilitySystemIndex&) = delete;
+
+	/**
+	 * Gets the index of the game instance the object is in
+	 * @return Null if the object isn't in a game instance
+	 */
+	static FContext_AbilitySystemIndex* Find(const UObject* WorldContextObject);
+
+	/**
+	 * Version of the ability system's owned tags. Changes whenever any of them change.
+	 */
+	uint32 GetTagVersion(UAbilitySystemComponent* AbilitySystem);
+
+	/**
+	 * Version of the ability system's granted abilities. Changes whenever abilities are granted or removed.
+	 */
+	uint32 GetAbilityVersion(UAbilitySystemComponent* AbilitySystem);
+
+	/**
+	 * Checks if any granted ability has every tag, matching exactly. Same result as FindAllAbilitiesWithTags
+	 * returning anything, without allocating or scanning every spec.
+	 */
+	bool HasAbilityWithTags(UAbilitySystemComponent* AbilitySystem, const FGameplayTagContainer& Tags);
+
+	/**
+	 * Stops listening to every ability system and forgets about them
+	 */
+	void Reset();
+
+private:
+	struct FState {
+		TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+		FDelegateHandle TagChangedHandle;
+		FDelegateHandle SpecDirtiedHandle;
+		
+		uint32 TagVersion = 1;
+		uint32 AbilityVersion = 1;
+		
+		/** Ability version the index below was built for */
+		uint32 IndexedAbilityVersion = 0;
+
+		/** Hash of the granted specs when the ability version was last checked, see RefreshAbilityVersion */
+		uint32 AbilitiesHash = 0;
+		uint64 AbilitiesCheckedFrame = 0;
+		bool bAbilitiesMaybeChanged = false;
+
+		/** Tags of every granted ability */
+		TArray<FGameplayTagContainer> AbilityTags;
+
+		/** Indices into AbilityTags of every ability having the tag */
+		TMap<FGameplayTag, TArray<int32, TInlineAllocator<4>>> AbilitiesByTag;
+	};
+
+	/**
+	 * Gets the state of an ability system, starting to track it if needed
+	 */
+	FState& Watch(UAbilitySystemComponent* AbilitySystem);
+
+	/**
+	 * Bumps the ability version if the granted specs changed. Specs are hashed when the ability system flagged a spec
+	 * dirty, which it also does on activation, and once a frame otherwise to catch grants and removals replicated
+	 * to clients, which don't flag anything.
+	 */
+	void RefreshAbilityVersion(FState& State) const;
+
+	/**
+	 * Hashes the handle and ability of every granted spec
+	 */
+	static uint32 HashAbilities(const UAbilitySystemComponent* AbilitySystem);
+
+	/**
+	 * Removes our delegates from a tracked ability system, if it still exists
+	 */
+	static void Unwatch(FState& State);
+
+	/**
+	 * Rebuilds the ability tag index if abilities changed since it was built
+	 */
+	void RefreshAbilityIndex(FState& State) const;
+
+	/**
+	 * Drops ability systems that no longer exist, once there are too many of them
+	 */
+	void PruneIfNeeded();
+
+	TMap<TObjectKey<UAbilitySystemComponent>, FState> States;
+
+	static constexpr int32 MaxStates = 512;
+};
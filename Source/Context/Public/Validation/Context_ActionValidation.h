@@ -23,6 +23,38 @@ enum EActionValidation_Severity {
 	NoFail
 };
 
+/**
+ * Rough cost of running a validation. Entries run their cheapest validations first, so expensive ones are skipped
+ * when a cheap one already failed.
+ */
+UENUM(BlueprintType)
+enum class EContext_ValidationCost : uint8 {
+	/** Only checks gameplay tags */
+	Tags,
+	/** Looks up granted abilities */
+	Ability,
+	/** Any other native validation */
+	Native,
+	/** Implemented in Blueprint */
+	Blueprint,
+};
+
+/**
+ * What a validation's result depends on, which decides how long it can be reused for.
+ * See FContext_ValidationMemo
+ */
+UENUM(BlueprintType)
+enum class EContext_ValidationDependency : uint8 {
+	/** Depends on anything, so it's evaluated every time */
+	Always,
+	/** Reused for the rest of the frame */
+	Frame,
+	/** Only depends on the gameplay tags of the subjects. Reused until their ability system's tags change */
+	Tags,
+	/** Only depends on the abilities granted to the subjects. Reused until their ability system's abilities change */
+	Abilities,
+};
+
 /**
  * 
  */
@@ -42,11 +74,38 @@ class CONTEXT_API UContext_ActionValidation : public UObject {
 	UPROPERTY(EditDefaultsOnly)
 	TArray<UContext_ActionValidationResult*> OnFail;
 
+protected:
+	/**
+	 * What this validation's result depends on. Evaluated every time by default. Only opt in to reusing its result if
+	 * it's a pure function of what's selected here: a Tags validation must not read inventory, stats or world state.
+	 */
+	UPROPERTY(EditDefaultsOnly, AdvancedDisplay)
+	EContext_ValidationDependency ValidationDependency = EContext_ValidationDependency::Always;
+
 public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category="Context|Validation")
 	bool RunValidation(AActor* Caller, AActor* ContextOwner); 
+
+	/**
+	 * How expensive this validation is to run. Validations implemented in Blueprint are assumed to be the most expensive.
+	 */
+	virtual EContext_ValidationCost GetValidationCost() const;
+
+	EActionValidation_Severity GetValidationSeverity() const { return ValidationSeverity; }
+
+	EContext_ValidationDependency GetValidationDependency() const { return ValidationDependency; }
+
+	/**
+	 * Gets soft referenced assets used by this validation's results, so they can be streamed in with its entry
+	 * @param OutAssets Array to add the assets to
+	 */
+	void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const;
 	
 protected:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category="Context|Validation")
 	bool OnValidationStart(AActor* Entity); 
+
+private:
+	/// Runs OnValidationStart on the validation subjects
+	bool EvaluateSubjects(AActor* Caller, AActor* ContextOwner);
 };
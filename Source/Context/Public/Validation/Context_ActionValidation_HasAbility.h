@@ -17,6 +17,11 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	FGameplayTagContainer RequiredAbilityTag;
 
+public:
+	UContext_ActionValidation_HasAbility();
+	
+	virtual EContext_ValidationCost GetValidationCost() const override { return EContext_ValidationCost::Ability; }
+
 protected:
 	virtual bool OnValidationStart_Implementation(AActor* Entity) override;
 
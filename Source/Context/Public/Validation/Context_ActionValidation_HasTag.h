@@ -15,8 +15,12 @@ class CONTEXT_API UContext_ActionValidation_HasTag : public UContext_ActionValid
 	GENERATED_BODY()
 
 public:
+	UContext_ActionValidation_HasTag();
+	
 	UPROPERTY(EditDefaultsOnly)
 	FGameplayTagContainer RequiredTags;
+
+	virtual EContext_ValidationCost GetValidationCost() const override { return EContext_ValidationCost::Tags; }
 	
 protected:
 	virtual bool OnValidationStart_Implementation(AActor* Entity) override;
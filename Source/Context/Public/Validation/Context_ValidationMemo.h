@@ -0,0 +1,77 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class FContext_AbilitySystemIndex;
+class UContext_ActionValidation;
+enum class EContext_ValidationDependency : uint8;
+
+/**
+ * Remembers validation results per validation, caller and owner, so menus, prompts and execution asking for the same
+ * validation don't evaluate it again. How long a result is reused for depends on the validation's
+ * EContext_ValidationDependency. Tag and ability dependent results are reused until the subjects' ability systems change,
+ * as tracked by FContext_AbilitySystemIndex.
+ * Owned by the action subsystem, so every game instance (PIE instance) has its own. Game thread only.
+ */
+class CONTEXT_API FContext_ValidationMemo {
+public:
+	explicit FContext_ValidationMemo(FContext_AbilitySystemIndex& InAbilitySystemIndex)
+		: AbilitySystemIndex(InAbilitySystemIndex) {}
+	
+	/**
+	 * Gets the memo of the game instance the actors are in
+	 * @return Null if neither actor is in a game instance, in which case nothing should be memoized
+	 */
+	static FContext_ValidationMemo* Find(const AActor* Caller, const AActor* ContextOwner);
+
+	/**
+	 * Finds a result that's still valid for the validation and its subjects
+	 * @return False on a miss, in which case the validation must be evaluated and stored
+	 */
+	bool Find(const UContext_ActionValidation* Validation, const AActor* Caller, const AActor* ContextOwner, bool& bOutResult);
+
+	void Store(const UContext_ActionValidation* Validation, const AActor* Caller, const AActor* ContextOwner, const bool bResult);
+
+	/**
+	 * Drops every remembered result
+	 */
+	void Reset();
+
+	uint64 GetHits() const { return Hits; }
+	uint64 GetMisses() const { return Misses; }
+	void ResetStats();
+
+private:
+	using FKey = TTuple<TObjectKey<UContext_ActionValidation>, TObjectKey<AActor>, TObjectKey<AActor>>;
+	
+	struct FResult {
+		bool bResult = false;
+		uint64 Frame = 0;
+		uint32 CallerVersion = 0;
+		uint32 OwnerVersion = 0;
+	};
+
+	/**
+	 * Gets the version of the state a dependency relies on for an actor
+	 * @return False if the actor's state can't be tracked, in which case results only last a frame
+	 */
+	bool GetStateVersion(const AActor* Actor, const EContext_ValidationDependency Dependency, uint32& OutVersion);
+
+	/**
+	 * Drops every result once there are too many of them
+	 */
+	void PruneIfNeeded();
+
+	/** Versions of the subjects' ability systems, owned by the same subsystem */
+	FContext_AbilitySystemIndex& AbilitySystemIndex;
+	
+	TMap<FKey, FResult> Results;
+
+	uint64 Hits = 0;
+	uint64 Misses = 0;
+
+	static constexpr int32 MaxResults = 4096;
+};
@@ -24,6 +24,10 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category="Context|Validation|Result")
 	void RunResultAction(AActor* Caller, AActor* ContextOwner);
 
+	/// Adds soft referenced assets this result uses, so they're streamed in with its entry
+	/// @param OutAssets 
+	virtual void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const {}
+
 protected:
 	/// Internal function that actually has functionality. This is what you need to override!
 	/// @param Entity 
@@ -15,8 +15,10 @@ class CONTEXT_API UContext_ActionValidationResult_PlaySound : public UContext_Ac
 
 public:
 	
-	UPROPERTY(EditDefaultsOnly)
-	TObjectPtr<USoundBase> SoundCueToPlay;
+	UPROPERTY(EditDefaultsOnly, meta = (AssetBundles = "Action"))
+	TSoftObjectPtr<USoundBase> SoundCueToPlay;
+
+	virtual void GetStreamedAssets(TArray<FSoftObjectPath>& OutAssets) const override;
 
 protected:
 	virtual void OnResultActionStart_Implementation(AActor* Entity) override;
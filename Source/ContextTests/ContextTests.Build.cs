@@ -0,0 +1,25 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Benchmark and automation tests of the Context module. A developer tool module, so none of it ships.
+public class ContextTests : ModuleRules
+{
+	public ContextTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Context",
+				"Core",
+				"CoreUObject",
+				"DeveloperSettings",
+				"Engine",
+				"GameplayAbilities",
+				"GameplayTags",
+			}
+			);
+	}
+}
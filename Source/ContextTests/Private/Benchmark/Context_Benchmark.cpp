@@ -0,0 +1,352 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Benchmark/Context_Benchmark.h"
+#include "Benchmark/Context_BenchmarkTypes.h"
+
+#include "Context_Settings.h"
+#include "Actions/Context_ActionEntry.h"
+#include "Actions/Context_ActionSubsystem.h"
+#include "Components/Context_HolderComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogContextBenchmark, Log, All);
+
+AContext_BenchmarkHolderActor::AContext_BenchmarkHolderActor() {
+	PrimaryActorTick.bCanEverTick = false;
+	ContextHolder = CreateDefaultSubobject<UContext_HolderComponent>(TEXT("ContextHolder"));
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ * Context.Benchmark measures how long context queries take for a given amount of content, and writes the latency
+ * distributions to Saved/Profiling/Context as CSV and JSON.
+ *
+ * To gate regressions, run the Context.Benchmark automation tests (Context_BenchmarkTest.cpp), for example:
+ * UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests Context.Benchmark;Quit"
+ *
+ * The console command runs the same benchmark in the current game world, for example:
+ * UnrealEditor-Cmd <Project> -game -nullrhi -unattended -ExecCmds="Context.Benchmark Holders=500 Depth=4,Quit"
+ *
+ * Arguments (all optional):
+ * Holders=		Number of holders (256)
+ * Entries=		Entries per holder (8)
+ * Depth=		Givers above every holder, each passing down one entry (4)
+ * Validations=	Validations per entry, never memoized (2)
+ * Iterations=	Calls measured per query (10000)
+ * Mode=		Execution mode of the benchmark action, Instanced, Pooled or Stateless (Instanced)
+ * Out=			Output file name, without extension (ContextBenchmark_<date>)
+ *
+ * Holder actors are spawned into the world, so they begin play and register with the action subsystem like they would
+ * in a game. Spawned actors have their level as outer, which ends the context tree at the level, so to get deeper
+ * trees every holder actor is then moved into a chain of giver objects hanging off the level.
+ */
+namespace ContextBenchmark {
+	/** Objects created for a run */
+	struct FContent {
+		TArray<AContext_BenchmarkHolderActor*> HolderActors;
+		TArray<UObject*> Objects;
+		UContext_ActionEntry* PrimaryEntry = nullptr;
+	};
+
+	void FResult::Summarize() {
+		if (Samples.IsEmpty()) return;
+
+		Samples.Sort();
+		const auto Percentile = [this](const double P) {
+			const int32 Index = FMath::Clamp(FMath::CeilToInt32(P * Samples.Num()) - 1, 0, Samples.Num() - 1);
+			return Samples[Index];
+		};
+
+		double Total = 0;
+		for (const double Sample : Samples) {
+			Total += Sample;
+		}
+
+		Min = Samples[0];
+		Max = Samples.Last();
+		Mean = Total / Samples.Num();
+		P50 = Percentile(0.5);
+		P90 = Percentile(0.9);
+		P99 = Percentile(0.99);
+	}
+
+	FConfig ParseConfig(const FString& Args) {
+		FConfig Config;
+		const TCHAR* Line = *Args;
+		
+		FParse::Value(Line, TEXT("Holders="), Config.Holders);
+		FParse::Value(Line, TEXT("Entries="), Config.Entries);
+		FParse::Value(Line, TEXT("Depth="), Config.Depth);
+		FParse::Value(Line, TEXT("Validations="), Config.Validations);
+		FParse::Value(Line, TEXT("Iterations="), Config.Iterations);
+		FParse::Value(Line, TEXT("Out="), Config.OutName);
+
+		FString ModeName;
+		if (FParse::Value(Line, TEXT("Mode="), ModeName)) {
+			const int64 ModeValue = StaticEnum<EContext_ActionExecutionMode>()->GetValueByNameString(ModeName);
+			if (ModeValue != INDEX_NONE) {
+				Config.Mode = static_cast<EContext_ActionExecutionMode>(ModeValue);
+			}
+		}
+
+		Config.Holders = FMath::Max(Config.Holders, 1);
+		Config.Entries = FMath::Max(Config.Entries, 1);
+		Config.Depth = FMath::Max(Config.Depth, 0);
+		Config.Validations = FMath::Max(Config.Validations, 0);
+		Config.Iterations = FMath::Max(Config.Iterations, 1);
+
+		if (Config.OutName.IsEmpty()) {
+			Config.OutName = FString::Printf(TEXT("ContextBenchmark_%s"), *FDateTime::Now().ToString());
+		}
+		
+		return Config;
+	}
+
+	static UContext_ActionEntry* CreateEntry(const FConfig& Config, const FString& Name, TArray<UObject*>& OutObjects) {
+		UContext_ActionEntry* Entry = NewObject<UContext_ActionEntry>(GetTransientPackage(), NAME_None, RF_Transient);
+		Entry->ActionName = FText::FromString(Name);
+		Entry->PayloadId = TEXT("Benchmark");
+		Entry->Action = TSoftClassPtr<UContext_Action>(UContext_BenchmarkAction::StaticClass());
+		
+		for (int32 Index = 0; Index < Config.Validations; Index++) {
+			Entry->Validations.Add(NewObject<UContext_BenchmarkValidation>(Entry));
+		}
+
+		OutObjects.Add(Entry);
+		return Entry;
+	}
+
+	static void CreateContent(UWorld* World, const FConfig& Config, FContent& OutContent) {
+		// Givers, from the top of the tree down
+		UObject* Outer = World->PersistentLevel;
+		for (int32 Depth = 0; Depth < Config.Depth; Depth++) {
+			UContext_BenchmarkGiver* Giver = NewObject<UContext_BenchmarkGiver>(Outer, NAME_None, RF_Transient);
+			Giver->PrimaryEntry = CreateEntry(Config, FString::Printf(TEXT("Giver%d"), Depth), OutContent.Objects);
+			Giver->Entries.Add(Giver->PrimaryEntry);
+			
+			// Only the top giver has a payload, so searches walk the whole chain
+			if (Depth == 0) {
+				Giver->Payload = NewObject<UContext_BenchmarkTreePayload>(Giver);
+			}
+
+			OutContent.Objects.Add(Giver);
+			Outer = Giver;
+		}
+
+		TSet<UContext_ActionEntry*> Entries;
+		for (int32 Index = 0; Index < Config.Entries; Index++) {
+			Entries.Add(CreateEntry(Config, FString::Printf(TEXT("Entry%d"), Index), OutContent.Objects));
+		}
+
+		OutContent.PrimaryEntry = *Entries.CreateConstIterator();
+		TArray<UContext_ActionEntry*> PrimaryEntries;
+		PrimaryEntries.Add(OutContent.PrimaryEntry);
+		
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.ObjectFlags = RF_Transient;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		
+		for (int32 Index = 0; Index < Config.Holders; Index++) {
+			AContext_BenchmarkHolderActor* HolderActor = World->SpawnActor<AContext_BenchmarkHolderActor>(SpawnParameters);
+			if (Outer != World->PersistentLevel) {
+				// Renaming out of the level unregisters the components, the holder needs them registered
+				HolderActor->Rename(nullptr, Outer, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+				HolderActor->RegisterAllComponents();
+			}
+			
+			HolderActor->Payload = NewObject<UContext_BenchmarkPayload>(HolderActor);
+			HolderActor->ContextHolder->SetContextEntries(Entries);
+			HolderActor->ContextHolder->SetPrimaryContextEntryPriority(PrimaryEntries);
+			
+			OutContent.HolderActors.Add(HolderActor);
+		}
+	}
+
+	static void DestroyContent(UWorld* World, FContent& Content) {
+		for (AContext_BenchmarkHolderActor* HolderActor : Content.HolderActors) {
+			World->DestroyActor(HolderActor);
+		}
+		
+		for (UObject* Object : Content.Objects) {
+			Object->MarkAsGarbage();
+		}
+		
+		Content.HolderActors.Empty();
+		Content.Objects.Empty();
+	}
+
+	/** Calls Query once per iteration, going round the holders, and records how long every call took */
+	template<typename QueryType>
+	static FResult Measure(const TCHAR* Name, const FConfig& Config, const FContent& Content, QueryType&& Query) {
+		FResult Result;
+		Result.Name = Name;
+		Result.Samples.Reserve(Config.Iterations);
+		
+		for (int32 Iteration = 0; Iteration < Config.Iterations; Iteration++) {
+			UContext_HolderComponent* Holder = Content.HolderActors[Iteration % Content.HolderActors.Num()]->ContextHolder;
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Query(Holder);
+			Result.Samples.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0);
+		}
+
+		Result.Summarize();
+		return Result;
+	}
+
+	void WriteResults(const FConfig& Config, const TArray<FResult>& Results, FOutputDevice& Ar) {
+		const FString Directory = FPaths::ProfilingDir() / TEXT("Context");
+		const FString ModeName = StaticEnum<EContext_ActionExecutionMode>()->GetNameStringByValue(static_cast<int64>(Config.Mode));
+		
+		FString Csv = TEXT("Query,Calls,MinUs,MeanUs,P50Us,P90Us,P99Us,MaxUs\n");
+		for (const FResult& Result : Results) {
+			Csv += FString::Printf(TEXT("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+				*Result.Name, Result.Samples.Num(), Result.Min, Result.Mean, Result.P50, Result.P90, Result.P99, Result.Max);
+		}
+
+		FString Json = TEXT("{\n\t\"config\": {\n");
+		Json += FString::Printf(TEXT("\t\t\"holders\": %d,\n\t\t\"entries\": %d,\n\t\t\"depth\": %d,\n\t\t\"validations\": %d,\n\t\t\"iterations\": %d,\n"),
+			Config.Holders, Config.Entries, Config.Depth, Config.Validations, Config.Iterations);
+		Json += FString::Printf(TEXT("\t\t\"executionMode\": \"%s\",\n\t\t\"memoizeValidations\": %s,\n\t\t\"payloadCacheMode\": \"%s\"\n\t},\n"),
+			*ModeName,
+			GetDefault<UContext_Settings>()->bMemoizeValidations ? TEXT("true") : TEXT("false"),
+			*StaticEnum<EContext_PayloadCacheMode>()->GetNameStringByValue(static_cast<int64>(GetDefault<UContext_Settings>()->PayloadCacheMode)));
+		Json += TEXT("\t\"results\": [\n");
+		for (int32 Index = 0; Index < Results.Num(); Index++) {
+			const FResult& Result = Results[Index];
+			Json += FString::Printf(TEXT("\t\t{ \"query\": \"%s\", \"calls\": %d, \"minUs\": %.3f, \"meanUs\": %.3f, \"p50Us\": %.3f, \"p90Us\": %.3f, \"p99Us\": %.3f, \"maxUs\": %.3f }%s\n"),
+				*Result.Name, Result.Samples.Num(), Result.Min, Result.Mean, Result.P50, Result.P90, Result.P99, Result.Max,
+				Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+		}
+		Json += TEXT("\t]\n}\n");
+
+		const FString CsvPath = Directory / (Config.OutName + TEXT(".csv"));
+		const FString JsonPath = Directory / (Config.OutName + TEXT(".json"));
+		FFileHelper::SaveStringToFile(Csv, *CsvPath);
+		FFileHelper::SaveStringToFile(Json, *JsonPath);
+
+		for (const FResult& Result : Results) {
+			Ar.Logf(TEXT("%-36s p50 %8.3fus  p90 %8.3fus  p99 %8.3fus  max %8.3fus"),
+				*Result.Name, Result.P50, Result.P90, Result.P99, Result.Max);
+		}
+		Ar.Logf(TEXT("Context benchmark written to %s and %s"), *FPaths::ConvertRelativePathToFull(CsvPath), *FPaths::ConvertRelativePathToFull(JsonPath));
+	}
+
+	bool ReadBaseline(const FString& Path, TMap<FString, double>& OutP50s) {
+		FString Csv;
+		if (!FFileHelper::LoadFileToString(Csv, *Path)) {
+			return false;
+		}
+
+		// Columns as written by WriteResults
+		const FCsvParser Parser(Csv);
+		const FCsvParser::FRows& Rows = Parser.GetRows();
+		for (int32 Row = 1; Row < Rows.Num(); Row++) {
+			if (Rows[Row].Num() < 5) continue;
+			OutP50s.Add(Rows[Row][0], FCString::Atod(Rows[Row][4]));
+		}
+		return true;
+	}
+
+	bool Run(
+		UContext_ActionSubsystem* Subsystem,
+		AActor* Instigator,
+		const FConfig& Config,
+		TArray<FResult>& OutResults,
+		TArray<FString>& OutErrors) {
+
+		UWorld* World = Subsystem->GetWorld();
+		if (!World || !World->PersistentLevel) {
+			OutErrors.Add(TEXT("The action subsystem's game instance has no world to spawn the holders into"));
+			return false;
+		}
+
+		// The action's mode is read from its class default object
+		UContext_BenchmarkAction* ActionDefaults = GetMutableDefault<UContext_BenchmarkAction>();
+		const EContext_ActionExecutionMode PreviousMode = ActionDefaults->ExecutionMode;
+		ActionDefaults->ExecutionMode = Config.Mode;
+		
+		FContent Content;
+		CreateContent(World, Config, Content);
+		Subsystem->ClearContextCache();
+
+		UE_LOG(LogContextBenchmark, Log, TEXT("Running context benchmark: %d holders, %d entries, depth %d, %d validations, %d iterations"),
+			Config.Holders, Config.Entries, Config.Depth, Config.Validations, Config.Iterations);
+		
+		OutResults.Add(Measure(TEXT("GetValidContextEntriesForObject"), Config, Content, [Subsystem](UContext_HolderComponent* Holder) {
+			Subsystem->GetValidContextEntriesForObject(Holder->GetOwner());
+		}));
+		OutResults.Add(Measure(TEXT("GetPrimaryContextEntryForObject"), Config, Content, [Subsystem](UContext_HolderComponent* Holder) {
+			Subsystem->GetPrimaryContextEntryForObject(Holder->GetOwner());
+		}));
+		OutResults.Add(Measure(TEXT("FindContextPayloadInTree"), Config, Content, [Subsystem, &Config](UContext_HolderComponent* Holder) {
+			Subsystem->FindContextPayloadInTree(Holder, UContext_BenchmarkTreePayload::StaticClass(), Config.Depth + 1);
+		}));
+		
+		const UContext_ActionEntry* ExecutedEntry = Content.PrimaryEntry;
+		OutResults.Add(Measure(TEXT("ExecuteAction"), Config, Content, [Subsystem, ExecutedEntry, Instigator](UContext_HolderComponent* Holder) {
+			Subsystem->ExecuteAction(Holder, ExecutedEntry, Instigator);
+		}));
+
+		// Timings of queries returning the wrong thing are meaningless, so check them once
+		UContext_HolderComponent* Holder = Content.HolderActors[0]->ContextHolder;
+		const int32 NumValidEntries = Subsystem->GetValidContextEntriesForObject(Holder->GetOwner()).Num();
+		if (NumValidEntries != Config.Entries + Config.Depth) {
+			OutErrors.Add(FString::Printf(TEXT("GetValidContextEntriesForObject returned %d entries, expected %d"),
+				NumValidEntries, Config.Entries + Config.Depth));
+		}
+		if (Subsystem->GetPrimaryContextEntryForObject(Holder->GetOwner()) != Content.PrimaryEntry) {
+			OutErrors.Add(TEXT("GetPrimaryContextEntryForObject didn't return the holder's primary entry"));
+		}
+		if (Config.Depth > 0 && !Subsystem->FindContextPayloadInTree(Holder, UContext_BenchmarkTreePayload::StaticClass(), Config.Depth + 1)) {
+			OutErrors.Add(TEXT("FindContextPayloadInTree didn't find the payload at the top of the tree"));
+		}
+		if (!Subsystem->ExecuteAction(Holder, ExecutedEntry, Instigator)) {
+			OutErrors.Add(TEXT("ExecuteAction failed"));
+		}
+
+		// Nothing the benchmark created should stay cached
+		Subsystem->ClearContextCache();
+		DestroyContent(World, Content);
+		ActionDefaults->ExecutionMode = PreviousMode;
+
+		return OutErrors.IsEmpty();
+	}
+
+	static void RunCommand(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar) {
+		const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UContext_ActionSubsystem* Subsystem = GameInstance ? GameInstance->GetSubsystem<UContext_ActionSubsystem>() : nullptr;
+		if (!Subsystem) {
+			Ar.Logf(ELogVerbosity::Error, TEXT("Context.Benchmark needs a game world with a game instance"));
+			return;
+		}
+		
+		const FConfig Config = ParseConfig(FString::Join(Args, TEXT(" ")));
+		
+		TArray<FResult> Results;
+		TArray<FString> Errors;
+		Run(Subsystem, UGameplayStatics::GetPlayerPawn(World, 0), Config, Results, Errors);
+		for (const FString& Error : Errors) {
+			Ar.Logf(ELogVerbosity::Error, TEXT("Context.Benchmark: %s"), *Error);
+		}
+
+		WriteResults(Config, Results, Ar);
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchmarkCommand(
+		TEXT("Context.Benchmark"),
+		TEXT("Measures context query latencies and writes them to Saved/Profiling/Context. ")
+		TEXT("Args: Holders= Entries= Depth= Validations= Iterations= Mode=Instanced|Pooled|Stateless Out="),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&RunCommand));
+}
+
+#endif
@@ -0,0 +1,64 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Actions/Context_Action.h"
+
+class AActor;
+class UContext_ActionSubsystem;
+
+/**
+ * Measures how long context queries take for a given amount of content, see Context_Benchmark.cpp.
+ * Driven by the Context.Benchmark console command and the Context.Benchmark automation tests.
+ */
+namespace ContextBenchmark {
+	struct FConfig {
+		int32 Holders = 256;
+		int32 Entries = 8;
+		int32 Depth = 4;
+		int32 Validations = 2;
+		int32 Iterations = 10000;
+		EContext_ActionExecutionMode Mode = EContext_ActionExecutionMode::Instanced;
+		FString OutName;
+	};
+
+	/** Latency distribution of a single query, in microseconds */
+	struct FResult {
+		FString Name;
+		TArray<double> Samples;
+		double Min = 0, Max = 0, Mean = 0, P50 = 0, P90 = 0, P99 = 0;
+
+		void Summarize();
+	};
+
+	/**
+	 * Reads a config from console command style arguments, e.g. "Holders=500 Depth=4". Missing arguments keep defaults.
+	 */
+	FConfig ParseConfig(const FString& Args);
+
+	/**
+	 * Creates the content in the world of the subsystem's game instance, measures every query, and destroys it again
+	 * @param Instigator Actor executing the benchmarked action. May be null
+	 * @param OutResults One result per query
+	 * @param OutErrors Queries that didn't return what the content should make them return
+	 * @return True if every query returned what it should
+	 */
+	bool Run(UContext_ActionSubsystem* Subsystem, AActor* Instigator, const FConfig& Config, TArray<FResult>& OutResults, TArray<FString>& OutErrors);
+
+	/**
+	 * Writes results to Saved/Profiling/Context as <OutName>.csv and <OutName>.json
+	 */
+	void WriteResults(const FConfig& Config, const TArray<FResult>& Results, FOutputDevice& Ar);
+
+	/**
+	 * Reads the p50 of every query from a CSV previously written by WriteResults
+	 * @return False if the file couldn't be read
+	 */
+	bool ReadBaseline(const FString& Path, TMap<FString, double>& OutP50s);
+}
+
+#endif
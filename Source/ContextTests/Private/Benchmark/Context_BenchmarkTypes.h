@@ -0,0 +1,102 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Context_ActionPayloadBase.h"
+#include "Actions/Context_Action.h"
+#include "GameFramework/Actor.h"
+#include "Interface/Context_Giver.h"
+#include "Validation/Context_ActionValidation.h"
+#include "Context_BenchmarkTypes.generated.h"
+
+class UContext_HolderComponent;
+
+/**
+ * Minimal content used by the Context benchmark and automation tests, see Context_Benchmark.cpp.
+ * None of these do any work of their own, so timings only contain the plugin's overhead.
+ */
+
+/** Payload handed out by benchmark holders */
+UCLASS(Transient, NotBlueprintable)
+class UContext_BenchmarkPayload : public UContext_ActionPayloadBase {
+	GENERATED_BODY()
+};
+
+/** Payload handed out by the top of the benchmark giver chain, so tree searches walk the whole chain */
+UCLASS(Transient, NotBlueprintable)
+class UContext_BenchmarkTreePayload : public UContext_ActionPayloadBase {
+	GENERATED_BODY()
+};
+
+/** Action that only checks its payload */
+UCLASS(Transient, NotBlueprintable)
+class UContext_BenchmarkAction : public UContext_Action {
+	GENERATED_BODY()
+
+public:
+	UContext_BenchmarkAction() {
+		PayloadClass = UContext_BenchmarkPayload::StaticClass();
+	}
+};
+
+/** Native validation that always passes, and is never memoized */
+UCLASS(Transient, NotBlueprintable)
+class UContext_BenchmarkValidation : public UContext_ActionValidation {
+	GENERATED_BODY()
+
+public:
+	UContext_BenchmarkValidation() {
+		ValidationDependency = EContext_ValidationDependency::Always;
+	}
+	
+protected:
+	virtual bool OnValidationStart_Implementation(AActor* Entity) override { return true; }
+};
+
+/** Link of a benchmark giver chain. Each giver passes down one entry */
+UCLASS(Transient, NotBlueprintable)
+class UContext_BenchmarkGiver : public UObject, public IContext_Giver {
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TSet<UContext_ActionEntry*> Entries;
+
+	UPROPERTY()
+	UContext_ActionEntry* PrimaryEntry = nullptr;
+
+	UPROPERTY()
+	UContext_ActionPayloadBase* Payload = nullptr;
+
+	/** Bumped by the entry setters, so the subsystem can cache our entries */
+	uint32 ContextVersion = 1;
+
+	virtual void AddContextEntry_Implementation(UContext_ActionEntry* ContextEntry) override { Entries.Add(ContextEntry); ContextVersion++; }
+	virtual void RemoveContextEntry_Implementation(UContext_ActionEntry* ContextEntry) override { Entries.Remove(ContextEntry); ContextVersion++; }
+	virtual uint32 GetContextVersion() const override { return ContextVersion; }
+	virtual void GetGiverContextEntries_Implementation(TSet<UContext_ActionEntry*>& OutContextEntries) override { OutContextEntries = Entries; }
+	virtual UContext_ActionEntry* GetPrimaryContextEntry_Implementation() override { return PrimaryEntry; }
+	virtual UContext_ActionPayloadBase* RequestContextPayload_Implementation(TSubclassOf<UContext_ActionPayloadBase> PayloadClass) override {
+		return Payload && Payload->IsA(PayloadClass) ? Payload : nullptr;
+	}
+};
+
+/** Actor owning the benchmarked holder component, and providing its entries' payload */
+UCLASS(Transient, NotBlueprintable, NotPlaceable)
+class AContext_BenchmarkHolderActor : public AActor {
+	GENERATED_BODY()
+
+public:
+	AContext_BenchmarkHolderActor();
+	
+	UPROPERTY()
+	UContext_HolderComponent* ContextHolder;
+
+	UPROPERTY()
+	UContext_ActionPayloadBase* Payload = nullptr;
+
+	/** Payload function for entries with the PayloadId "Benchmark" */
+	UFUNCTION()
+	UContext_ActionPayloadBase* GetPayload_Benchmark() const { return Payload; }
+};
@@ -0,0 +1,95 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "Actions/Context_ActionSubsystem.h"
+#include "Benchmark/Context_Benchmark.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Tests/Context_TestGameInstance.h"
+
+/**
+ * Runs the context benchmark (see Context_Benchmark.cpp) for a few content sizes, headless:
+ * UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests Context.Benchmark;Quit"
+ *
+ * Every run fails if a query returns the wrong thing, and writes its results to Saved/Profiling/Context.
+ * To gate regressions, copy a known good run's CSVs somewhere and pass:
+ * -ContextBenchmarkBaseline=<Directory>	Runs fail if a query's p50 regressed against the CSV of the same name
+ * -ContextBenchmarkTolerance=<Fraction>	How much slower than the baseline a p50 may be (0.25)
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FContext_BenchmarkTest,
+	"Context.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FContext_BenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const {
+	// Same arguments as the Context.Benchmark console command
+	static const TCHAR* Runs[][2] = {
+		{ TEXT("Small"), TEXT("Holders=32 Entries=4 Depth=1 Validations=1 Iterations=2000") },
+		{ TEXT("Default"), TEXT("") },
+		{ TEXT("DeepTree"), TEXT("Holders=64 Depth=9") },
+		{ TEXT("ManyHolders"), TEXT("Holders=2048 Iterations=20000") },
+		{ TEXT("Pooled"), TEXT("Mode=Pooled") },
+		{ TEXT("Stateless"), TEXT("Mode=Stateless") },
+	};
+
+	for (const auto& Run : Runs) {
+		OutBeautifiedNames.Add(Run[0]);
+		OutTestCommands.Add(FString::Printf(TEXT("%s Out=ContextBenchmarkTest_%s"), Run[1], Run[0]));
+	}
+}
+
+bool FContext_BenchmarkTest::RunTest(const FString& Parameters) {
+	FContext_TestGameInstance TestGameInstance;
+	UContext_ActionSubsystem* Subsystem = TestGameInstance.GetSubsystem<UContext_ActionSubsystem>();
+	if (!TestNotNull(TEXT("Action subsystem"), Subsystem)) {
+		return false;
+	}
+
+	const ContextBenchmark::FConfig Config = ContextBenchmark::ParseConfig(Parameters);
+	
+	TArray<ContextBenchmark::FResult> Results;
+	TArray<FString> Errors;
+	ContextBenchmark::Run(Subsystem, nullptr, Config, Results, Errors);
+	for (const FString& Error : Errors) {
+		AddError(Error);
+	}
+	
+	ContextBenchmark::WriteResults(Config, Results, *GLog);
+
+	// Regressions are only checked against a baseline when given one
+	FString BaselineDirectory;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("ContextBenchmarkBaseline="), BaselineDirectory)) {
+		return Errors.IsEmpty();
+	}
+
+	const FString BaselinePath = BaselineDirectory / (Config.OutName + TEXT(".csv"));
+	TMap<FString, double> BaselineP50s;
+	if (!ContextBenchmark::ReadBaseline(BaselinePath, BaselineP50s)) {
+		AddWarning(FString::Printf(TEXT("No baseline at %s, regressions weren't checked"), *BaselinePath));
+		return Errors.IsEmpty();
+	}
+
+	double Tolerance = 0.25;
+	FParse::Value(FCommandLine::Get(), TEXT("ContextBenchmarkTolerance="), Tolerance);
+
+	bool bRegressed = false;
+	for (const ContextBenchmark::FResult& Result : Results) {
+		const double* BaselineP50 = BaselineP50s.Find(Result.Name);
+		if (!BaselineP50) continue;
+
+		const double MaxP50 = *BaselineP50 * (1.0 + Tolerance);
+		if (Result.P50 > MaxP50) {
+			AddError(FString::Printf(TEXT("%s p50 regressed: %.3fus, baseline %.3fus (max %.3fus)"),
+				*Result.Name, Result.P50, *BaselineP50, MaxP50));
+			bRegressed = true;
+		}
+	}
+	
+	return Errors.IsEmpty() && !bRegressed;
+}
+
+#endif
@@ -0,0 +1,163 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Actions/Context_ActionEntry.h"
+#include "Actions/Context_ActionSubsystem.h"
+#include "Benchmark/Context_BenchmarkTypes.h"
+#include "Components/Context_HolderComponent.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/Context_TestGameInstance.h"
+#include "UObject/Package.h"
+
+#include <atomic>
+
+namespace ContextAllocationTest {
+	/**
+	 * Forwards everything to the real allocator, counting the allocations made by a single thread.
+	 * Other threads keep allocating through it while installed, so only the counted thread's allocations are reported.
+	 */
+	class FCountingMalloc final : public FMalloc {
+	public:
+		FMalloc* Inner = nullptr;
+		uint32 CountedThreadId = 0;
+		std::atomic<int32> NumAllocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override {
+			RecordAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override {
+			RecordAllocation();
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+			// Shrinking to nothing is a free
+			if (Count > 0) {
+				RecordAllocation();
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override {
+			if (Count > 0) {
+				RecordAllocation();
+			}
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void RecordAllocation() {
+			if (FPlatformTLS::GetCurrentThreadId() == CountedThreadId) {
+				++NumAllocations;
+			}
+		}
+	};
+
+	/**
+	 * Counts the allocations made by the calling thread for as long as it's in scope
+	 */
+	class FScopedAllocationCounter {
+	public:
+		FScopedAllocationCounter() {
+			FCountingMalloc& Counter = GetCounter();
+			Counter.Inner = GMalloc;
+			Counter.CountedThreadId = FPlatformTLS::GetCurrentThreadId();
+			Counter.NumAllocations = 0;
+			GMalloc = &Counter;
+		}
+
+		~FScopedAllocationCounter() {
+			GMalloc = GetCounter().Inner;
+		}
+
+		int32 GetNumAllocations() const { return GetCounter().NumAllocations; }
+
+	private:
+		// Other threads may still be inside it after it's uninstalled, so it's never destroyed while running
+		static FCountingMalloc& GetCounter() {
+			static FCountingMalloc Counter;
+			return Counter;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FContext_WarmQueryAllocationTest,
+	"Context.Query.WarmQueryDoesNotAllocate",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FContext_WarmQueryAllocationTest::RunTest(const FString& Parameters) {
+	using namespace ContextAllocationTest;
+	
+	FContext_TestGameInstance TestGameInstance;
+	UContext_ActionSubsystem* Subsystem = TestGameInstance.GetSubsystem<UContext_ActionSubsystem>();
+	if (!TestNotNull(TEXT("Action subsystem"), Subsystem)) {
+		return false;
+	}
+
+	// A holder with a few entries, below a giver passing one more down
+	const auto CreateEntry = []() {
+		UContext_ActionEntry* Entry = NewObject<UContext_ActionEntry>(GetTransientPackage(), NAME_None, RF_Transient);
+		Entry->Action = TSoftClassPtr<UContext_Action>(UContext_BenchmarkAction::StaticClass());
+		return Entry;
+	};
+
+	UWorld* World = TestGameInstance.GetWorld();
+	UContext_BenchmarkGiver* Giver = NewObject<UContext_BenchmarkGiver>(World->PersistentLevel, NAME_None, RF_Transient);
+	Giver->Entries.Add(CreateEntry());
+
+	TSet<UContext_ActionEntry*> Entries;
+	for (int32 Index = 0; Index < 8; Index++) {
+		Entries.Add(CreateEntry());
+	}
+
+	// Spawned so it begins play like a game holder, then moved below the giver, see Context_Benchmark.cpp
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags = RF_Transient;
+	AContext_BenchmarkHolderActor* HolderActor = World->SpawnActor<AContext_BenchmarkHolderActor>(SpawnParameters);
+	HolderActor->Rename(nullptr, Giver, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+	HolderActor->RegisterAllComponents();
+	HolderActor->ContextHolder->SetContextEntries(Entries);
+	const UContext_HolderComponent* Holder = HolderActor->ContextHolder;
+
+	// First query resolves and caches, and grows the buffer
+	TArray<UContext_ActionEntry*> ValidEntries;
+	Subsystem->CollectValidContextEntries(Holder, ValidEntries);
+	TestEqual(TEXT("Valid entries"), ValidEntries.Num(), Entries.Num() + 1);
+
+	int32 NumAllocations = 0;
+	{
+		FScopedAllocationCounter AllocationCounter;
+		for (int32 Iteration = 0; Iteration < 16; Iteration++) {
+			Subsystem->CollectValidContextEntries(Holder, ValidEntries);
+		}
+		NumAllocations = AllocationCounter.GetNumAllocations();
+	}
+
+	TestEqual(TEXT("Valid entries of a warm query"), ValidEntries.Num(), Entries.Num() + 1);
+	TestEqual(TEXT("Allocations made by warm queries"), NumAllocations, 0);
+
+	Subsystem->ClearContextCache();
+	World->DestroyActor(HolderActor);
+	Giver->MarkAsGarbage();
+	
+	return true;
+}
+
+#endif
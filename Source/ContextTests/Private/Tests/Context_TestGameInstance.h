@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "UObject/StrongObjectPtr.h"
+
+/**
+ * Standalone game instance for automation tests, with its own world and subsystems.
+ * Runs without a map or a viewport, so tests using it work under -nullrhi. Torn down when it goes out of scope.
+ * The world has begun play, so actors spawned into it run BeginPlay like they would in a game.
+ */
+struct FContext_TestGameInstance {
+	TStrongObjectPtr<UGameInstance> GameInstance;
+
+	FContext_TestGameInstance() {
+		GameInstance.Reset(NewObject<UGameInstance>(GEngine));
+		GameInstance->InitializeStandalone();
+
+		// There's no game mode to start play, so start it the way the world settings would
+		if (UWorld* World = GameInstance->GetWorld()) {
+			World->InitializeActorsForPlay(FURL());
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+	}
+
+	~FContext_TestGameInstance() {
+		UWorld* World = GameInstance->GetWorld();
+		GameInstance->Shutdown();
+		
+		if (World) {
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+	}
+
+	UWorld* GetWorld() const {
+		return GameInstance->GetWorld();
+	}
+
+	template<typename SubsystemType>
+	SubsystemType* GetSubsystem() const {
+		return GameInstance->GetSubsystem<SubsystemType>();
+	}
+};
+
+#endif